@@ -0,0 +1,110 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/threads.cc
+// Implementation of portable threading support
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <unistd.h>
+#include "threads.h"
+
+namespace {
+
+using namespace Gambit;
+
+//
+// Bookkeeping for one running thread; the entry point records whether
+// the task terminated with an exception, which cannot be propagated
+// across the thread boundary.
+//
+class ThreadData {
+public:
+  ThreadTask *m_task;
+  pthread_t m_thread;
+  bool m_failed;
+
+  ThreadData(void) : m_task(0), m_failed(false) { }
+};
+
+extern "C" void *ThreadEntry(void *p_data)
+{
+  ThreadData *data = static_cast<ThreadData *>(p_data);
+  try {
+    data->m_task->Run();
+  }
+  catch (...) {
+    data->m_failed = true;
+  }
+  return 0;
+}
+
+} // end anonymous namespace
+
+namespace Gambit {
+
+void RunThreads(const Array<ThreadTask *> &p_tasks)
+{
+  if (p_tasks.Length() == 1) {
+    // No need to start a thread for a single task
+    p_tasks[1]->Run();
+    return;
+  }
+
+  Array<ThreadData> threads(p_tasks.Length());
+  int started = 0;
+  for (int i = 1; i <= p_tasks.Length(); i++) {
+    threads[i].m_task = p_tasks[i];
+    if (pthread_create(&threads[i].m_thread, 0,
+		       ThreadEntry, &threads[i]) != 0) {
+      break;
+    }
+    started++;
+  }
+
+  bool failed = (started < p_tasks.Length());
+  for (int i = 1; i <= started; i++) {
+    pthread_join(threads[i].m_thread, 0);
+    failed = failed || threads[i].m_failed;
+  }
+
+  if (failed) {
+    throw ThreadException();
+  }
+}
+
+void RunThreads(ThreadTask &p_task, int p_numThreads)
+{
+  Array<ThreadTask *> tasks(p_numThreads);
+  for (int i = 1; i <= p_numThreads; i++) {
+    tasks[i] = &p_task;
+  }
+  RunThreads(tasks);
+}
+
+int NumProcessors(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n > 0) {
+    return (int) n;
+  }
+#endif  // _SC_NPROCESSORS_ONLN
+  return 1;
+}
+
+} // end namespace Gambit
@@ -0,0 +1,184 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/threads.h
+// Minimal portable threading support for parallel computations
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_THREADS_H
+#define LIBGAMBIT_THREADS_H
+
+#include <pthread.h>
+#include "libgambit.h"
+
+namespace Gambit {
+
+/// Exception thrown when a thread cannot be started, or when a task
+/// running on a thread terminates with an exception
+class ThreadException : public Exception {
+public:
+  virtual ~ThreadException() throw() { }
+  const char *what(void) const throw() { return "Error in worker thread"; }
+};
+
+class Condition;
+
+/// A mutual exclusion lock.  Objects of this class may not be copied.
+class Mutex {
+  friend class Condition;
+private:
+  pthread_mutex_t m_mutex;
+
+  Mutex(const Mutex &);
+  Mutex &operator=(const Mutex &);
+
+public:
+  Mutex(void) { pthread_mutex_init(&m_mutex, 0); }
+  ~Mutex() { pthread_mutex_destroy(&m_mutex); }
+
+  void Lock(void) { pthread_mutex_lock(&m_mutex); }
+  void Unlock(void) { pthread_mutex_unlock(&m_mutex); }
+};
+
+/// Holds a mutex locked for the lifetime of the object
+class MutexLock {
+private:
+  Mutex &m_mutex;
+
+  MutexLock(const MutexLock &);
+  MutexLock &operator=(const MutexLock &);
+
+public:
+  MutexLock(Mutex &p_mutex) : m_mutex(p_mutex) { m_mutex.Lock(); }
+  ~MutexLock() { m_mutex.Unlock(); }
+};
+
+/// A condition variable, used with a Mutex to wait for a change in
+/// shared state.  Objects of this class may not be copied.
+class Condition {
+private:
+  pthread_cond_t m_cond;
+
+  Condition(const Condition &);
+  Condition &operator=(const Condition &);
+
+public:
+  Condition(void) { pthread_cond_init(&m_cond, 0); }
+  ~Condition() { pthread_cond_destroy(&m_cond); }
+
+  /// Waits until signalled; the mutex must be locked by the caller,
+  /// and is released while waiting.
+  void Wait(Mutex &p_mutex) { pthread_cond_wait(&m_cond, &p_mutex.m_mutex); }
+  void Signal(void) { pthread_cond_signal(&m_cond); }
+  void Broadcast(void) { pthread_cond_broadcast(&m_cond); }
+};
+
+/// A stack of work items shared by several threads, each of which
+/// takes items with Pop() and may push new items while processing
+/// them.  The most recently pushed item is taken first, so a single
+/// thread traverses a search tree depth-first.
+template <class T> class WorkStack {
+private:
+  Mutex m_mutex;
+  Condition m_changed;
+  List<T> m_items;
+  int m_busy;
+  bool m_stopped;
+
+  WorkStack(const WorkStack<T> &);
+  WorkStack<T> &operator=(const WorkStack<T> &);
+
+public:
+  WorkStack(void) : m_busy(0), m_stopped(false) { }
+
+  void Push(const T &p_item)
+  { MutexLock lock(m_mutex); m_items.Append(p_item); m_changed.Signal(); }
+
+  /// Takes the next item, waiting while other threads are still
+  /// processing items and so may push more.  Returns false when the
+  /// work is complete, or Stop() has been called.  Each successful
+  /// call must be matched by a call to Done() once the item has been
+  /// processed.
+  bool Pop(T &p_item)
+  {
+    MutexLock lock(m_mutex);
+    while (m_items.Length() == 0 && m_busy > 0 && !m_stopped) {
+      m_changed.Wait(m_mutex);
+    }
+    if (m_stopped || m_items.Length() == 0) {
+      return false;
+    }
+    p_item = m_items.Remove(m_items.Length());
+    m_busy++;
+    return true;
+  }
+
+  void Done(void)
+  {
+    MutexLock lock(m_mutex);
+    if (--m_busy == 0 && m_items.Length() == 0) {
+      m_changed.Broadcast();
+    }
+  }
+
+  /// Abandons the remaining work; threads waiting in Pop() return false
+  void Stop(void)
+  { MutexLock lock(m_mutex); m_stopped = true; m_changed.Broadcast(); }
+  bool IsStopped(void) { MutexLock lock(m_mutex); return m_stopped; }
+
+  /// Takes an item without waiting, returning false if there is none.
+  /// This is for discarding the items left after Stop().
+  bool TryPop(T &p_item)
+  {
+    MutexLock lock(m_mutex);
+    if (m_items.Length() == 0) {
+      return false;
+    }
+    p_item = m_items.Remove(m_items.Length());
+    return true;
+  }
+};
+
+/// A unit of work which can be run on a thread
+class ThreadTask {
+public:
+  virtual ~ThreadTask() { }
+
+  /// Perform the work.  If the same task object is run on several
+  /// threads at once, the implementation is responsible for
+  /// synchronizing access to its own data.
+  virtual void Run(void) = 0;
+};
+
+/// Runs each of the tasks on its own thread, and returns when all
+/// have completed.  A task may appear more than once in the array,
+/// in which case it is run that many times concurrently.  Throws a
+/// ThreadException if any task exits with an exception.
+void RunThreads(const Array<ThreadTask *> &p_tasks);
+
+/// Runs the task on the specified number of threads at once, and
+/// returns when all have completed.
+void RunThreads(ThreadTask &p_task, int p_numThreads);
+
+/// Returns the number of processors available, or one if this
+/// cannot be determined.
+int NumProcessors(void);
+
+} // end namespace Gambit
+
+#endif // LIBGAMBIT_THREADS_H
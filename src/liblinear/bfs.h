@@ -25,6 +25,7 @@
 
 #include "libgambit/libgambit.h"
 #include <map>
+#include <vector>
 
 template <class T> class BFS {
 private:
@@ -50,6 +51,16 @@ public:
   }
   bool operator!=(const BFS &M) const  { return !(*this == M); }
 
+  // a hash of the basis, so that equal BFS's have equal hashes
+  unsigned long Hash(void) const {
+    unsigned long h = m_map.size();
+    for (typename std::map<int, T>::const_iterator iter = m_map.begin();
+	 iter != m_map.end(); iter++) {
+      h = h * 1000003UL + (unsigned long) ((*iter).first + 0x9e37);
+    }
+    return h;
+  }
+
   // Provide map-like operations
   int count(int key) const { return (m_map.count(key) > 0); }
 
@@ -68,6 +79,59 @@ public:
   }
 };
 
+//
+// A list of BFS's, indexed by a hash table on their bases, so that
+// finding a BFS in the list takes constant expected time.  As with
+// Gambit::List, elements are numbered from one.
+//
+template <class T> class BFSList {
+private:
+  std::vector<BFS<T> > m_items;
+  std::vector<std::vector<int> > m_buckets;
+
+  std::vector<int> &Bucket(const BFS<T> &p_bfs)
+    { return m_buckets[p_bfs.Hash() & (m_buckets.size() - 1)]; }
+  const std::vector<int> &Bucket(const BFS<T> &p_bfs) const
+    { return m_buckets[p_bfs.Hash() & (m_buckets.size() - 1)]; }
+
+  void Rehash(void) {
+    m_buckets = std::vector<std::vector<int> >(2 * m_buckets.size());
+    for (int i = 0; i < (int) m_items.size(); i++) {
+      Bucket(m_items[i]).push_back(i);
+    }
+  }
+
+public:
+  BFSList(void) : m_buckets(16) { }
+
+  int Length(void) const { return m_items.size(); }
+  const BFS<T> &operator[](int i) const { return m_items[i - 1]; }
+
+  // returns the index of the BFS with the same basis, or zero if none
+  int Find(const BFS<T> &p_bfs) const {
+    const std::vector<int> &bucket = Bucket(p_bfs);
+    for (int i = 0; i < (int) bucket.size(); i++) {
+      if (m_items[bucket[i]] == p_bfs) {
+	return bucket[i] + 1;
+      }
+    }
+    return 0;
+  }
+  bool Contains(const BFS<T> &p_bfs) const { return (Find(p_bfs) > 0); }
+
+  // appends the BFS, which should not already be in the list
+  int Append(const BFS<T> &p_bfs) {
+    m_items.push_back(p_bfs);
+    if (m_items.size() > m_buckets.size()) {
+      Rehash();
+    }
+    else {
+      Bucket(p_bfs).push_back(m_items.size() - 1);
+    }
+    return m_items.size();
+  }
+};
+
 #endif   // BFS_H
 
 
@@ -25,6 +25,7 @@
 
 #include "bfs.h"
 #include "basis.h"
+#include "sparse.h"
 
 // ---------------------------------------------------------------------------
 //                          BaseTableau Stuff
@@ -73,7 +74,10 @@ public:
 
 template <class T> class TableauInterface : public BaseTableau<T>{
 protected:
+  // the constraint matrix is held either dense, in A, or sparse, in
+  // sparseA; the other pointer is null
   const Gambit::Matrix<T> *A;  // should this be private?
+  const SparseMatrix<T> *sparseA;
   const Gambit::Vector<T> *b;  // should this be private?
   Basis basis; 
   Gambit::Vector<T> solution;  // current solution vector. should this be private?
@@ -85,6 +89,9 @@ public:
   TableauInterface(const Gambit::Matrix<T> &A, const Gambit::Vector<T> &b); 
   TableauInterface(const Gambit::Matrix<T> &A, const Gambit::Array<int> &art, 
 		   const Gambit::Vector<T> &b); 
+  TableauInterface(const SparseMatrix<T> &A, const Gambit::Vector<T> &b); 
+  TableauInterface(const SparseMatrix<T> &A, const Gambit::Array<int> &art, 
+		   const Gambit::Vector<T> &b); 
   TableauInterface(const TableauInterface<T>&);
   virtual ~TableauInterface();
 
@@ -98,7 +105,18 @@ public:
   int MaxCol() const;
 
   Basis & GetBasis(void);
+  // true if the constraint matrix is held sparse; Get_A() may only be
+  // called on tableaux which are not
+  bool IsSparse(void) const { return (sparseA != 0); }
   const Gambit::Matrix<T> & Get_A(void) const;
+  const SparseMatrix<T> & Get_SparseA(void) const { return *sparseA; }
+  // points the tableau at another matrix, which must have the same
+  // dimensions; Refactor() should be called before further use
+  void Set_A(const Gambit::Matrix<T> &p_A) { A = &p_A; sparseA = 0; }
+  void Set_A(const SparseMatrix<T> &p_A) { A = 0; sparseA = &p_A; }
+  // entry (i,j) of the constraint matrix, and the number of its columns
+  T Get_A(int i, int j) const { return (A) ? (*A)(i, j) : (*sparseA)(i, j); }
+  int MaxCol_A(void) const { return (A) ? A->MaxCol() : sparseA->MaxCol(); }
   const Gambit::Vector<T> & Get_b(void) const;
   
   bool Member(int i) const;
@@ -0,0 +1,134 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/liblinear/dominance.cc
+// Dominance of strategies by mixed strategies
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+
+#include "libgambit/libgambit.h"
+#include "dominance.h"
+#include "dualsimplex.h"
+
+using namespace Gambit;
+
+inline void Epsilon(double &v, int i = 8)
+{ v = ::pow(10.0, (double) -i); }
+
+inline void Epsilon(Rational &v, int /*i*/ = 8) { v = Rational(0); }
+
+//
+// For strict dominance, payoffs are shifted so all are at least one.
+// Then p_strategy is dominated if and only if there are weights x >= 0 on
+// the other strategies, with sum less than one, such that the weighted
+// payoffs are at least those of p_strategy against every contingency;
+// the LP minimizes the sum of the weights.
+//
+// For weak dominance, the weights are required to sum to one, and the LP
+// maximizes the total slack over the contingencies, which is positive if
+// and only if p_strategy is weakly dominated.
+//
+template <class T>
+bool IsMixedDominated(const StrategySupport &p_support,
+		      const GameStrategy &p_strategy, bool p_strict)
+{
+  int pl = p_strategy->GetPlayer()->GetNumber();
+  Array<GameStrategy> others;
+  for (int st = 1; st <= p_support.NumStrategies(pl); st++) {
+    if (p_support.GetStrategy(pl, st) != p_strategy) {
+      others.Append(p_support.GetStrategy(pl, st));
+    }
+  }
+  if (others.Length() == 0)  return false;
+
+  // Payoffs against each contingency; entry 0 is that of p_strategy
+  List<Array<Rational> > payoffs;
+  for (StrategyIterator iter(p_support, p_strategy); !iter.AtEnd(); iter++) {
+    Array<Rational> row(0, others.Length());
+    row[0] = (*iter)->GetStrategyValue(p_strategy);
+    for (int k = 1; k <= others.Length(); k++) {
+      row[k] = (*iter)->GetStrategyValue(others[k]);
+    }
+    payoffs.Append(row);
+  }
+
+  int rows = payoffs.Length() + ((p_strict) ? 0 : 1);
+  Matrix<T> A(1, rows, 1, others.Length());
+  Vector<T> b(1, rows), c(1, others.Length());
+  Rational shift = (p_strict) ? Rational(1) - p_support.GetGame()->GetMinPayoff(pl) : Rational(0);
+  T total = (T) 0;
+  c = (T) 0;
+  for (int t = 1; t <= payoffs.Length(); t++) {
+    b[t] = (T) -(payoffs[t][0] + shift);
+    total += (T) payoffs[t][0];
+    for (int k = 1; k <= others.Length(); k++) {
+      A(t, k) = (T) -(payoffs[t][k] + shift);
+      c[k] += (T) payoffs[t][k];
+    }
+  }
+  if (p_strict) {
+    c = (T) -1;
+  }
+  else {
+    for (int k = 1; k <= others.Length(); k++) {
+      A(rows, k) = (T) 1;
+    }
+    b[rows] = (T) 1;
+  }
+
+  DualSimplex<T> LP(A, b, c, (p_strict) ? 0 : 1);
+  if (!LP.IsFeasible() || !LP.IsBounded())  return false;
+
+  T eps;
+  ::Epsilon(eps);
+  if (p_strict) {
+    return (LP.OptimumCost() > (T) -1 + eps);
+  }
+  else {
+    return (LP.OptimumCost() - total > eps);
+  }
+}
+
+template <class T>
+StrategySupport UndominatedMixed(const StrategySupport &p_support,
+				 bool p_strict)
+{
+  StrategySupport newS(p_support);
+  Game game = p_support.GetGame();
+
+  for (int pl = 1; pl <= game->NumPlayers(); pl++) {
+    for (int st = 1; st <= game->GetPlayer(pl)->NumStrategies(); st++) {
+      GameStrategy strategy = game->GetPlayer(pl)->GetStrategy(st);
+      if (newS.Contains(strategy) &&
+	  IsMixedDominated<T>(newS, strategy, p_strict)) {
+	newS.RemoveStrategy(strategy);
+      }
+    }
+  }
+
+  return newS;
+}
+
+template bool IsMixedDominated<double>(const StrategySupport &,
+				       const GameStrategy &, bool);
+template bool IsMixedDominated<Rational>(const StrategySupport &,
+					 const GameStrategy &, bool);
+template StrategySupport UndominatedMixed<double>(const StrategySupport &, 
+						  bool);
+template StrategySupport UndominatedMixed<Rational>(const StrategySupport &, 
+						    bool);
@@ -0,0 +1,52 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/liblinear/dominance.h
+// Dominance of strategies by mixed strategies
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef DOMINANCE_H
+#define DOMINANCE_H
+
+#include "libgambit/libgambit.h"
+
+//
+// Dominance of a strategy by a mixed strategy over the other strategies
+// of its player in a support, which StrategySupport::IsDominated() does
+// not detect, since it only compares pairs of pure strategies.  Each test
+// solves a linear program with one row for each contingency of the other
+// players' strategies in the support, and so is found here rather than
+// in libgambit.  The template parameter gives the arithmetic used in
+// solving; with Gambit::Rational the test is exact.
+//
+
+// Returns true if p_strategy is dominated (strictly, if p_strict is set;
+// otherwise weakly) by some mixture of the other strategies of its
+// player in the support
+template <class T>
+bool IsMixedDominated(const Gambit::StrategySupport &p_support,
+		      const Gambit::GameStrategy &p_strategy, bool p_strict);
+
+// Returns a copy of the support with strategies which are dominated by
+// mixed strategies eliminated, one at a time, in the order in which
+// they appear in the game
+template <class T>
+Gambit::StrategySupport 
+UndominatedMixed(const Gambit::StrategySupport &p_support, bool p_strict);
+
+#endif  // DOMINANCE_H
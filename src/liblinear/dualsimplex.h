@@ -0,0 +1,112 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/liblinear/dualsimplex.h
+// Interface to bounded dual simplex LP solver
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef DUALSIMPLEX_H
+#define DUALSIMPLEX_H
+
+#include "libgambit/libgambit.h"
+#include "liblinear/sparse.h"
+#include "liblinear/tableau.h"
+
+//
+// This class implements a dual simplex LP solver.  Like LPSolve, it
+// takes as input a problem of the form maximize c x subject to A x <= b,
+// x >= 0, where the last k rows (the parameter "nequals") are equalities.
+// In addition, any of the variables may be given an upper bound.
+//
+// The solver works on the basis factorizations of Tableau, so it runs
+// with either dense or sparse A, in floating point or exact arithmetic.
+// Before solving, rows and columns of A which are empty are removed,
+// and (in floating point only) rows and columns are scaled by powers of
+// two to bring the entries of A close to one.  The leaving variable is
+// chosen by dual steepest-edge pricing, and the entering variable by a
+// ratio test which prefers large pivots among near-ties.
+//
+// Variables whose cost would make the initial slack basis dual
+// infeasible, and which have no upper bound, are given a large artificial
+// bound, which is relaxed if it is still binding at the optimum.  The
+// problem is reported unbounded if it remains binding after several
+// relaxations.
+//
+// As in LPSolve, all computation is done in the class constructor.
+// OptimumVector() returns the values of the columns of A at the optimum,
+// and DualVector() the values of the dual variables of the rows.
+// GetBasis() returns the basic variables at the optimum, labelled j for
+// column j of A and -i for the slack of row i.  These may be passed as
+// the starting basis of another solve, for example to solve a problem
+// exactly starting from the optimal basis found in floating point.
+//
+
+template <class T> class DualSimplex {
+private:
+  int m_nequals;
+  bool m_feasible, m_bounded;
+  long m_npivots;
+  T m_cost;
+  Gambit::Vector<T> m_primal, m_dual;
+  Gambit::Array<int> m_basis;
+
+  void Compute(const SparseMatrix<T> &A, const Gambit::Vector<T> &b,
+	       const Gambit::Vector<T> &c,
+	       const Gambit::Array<bool> &hasUpper,
+	       const Gambit::Vector<T> &upper,
+	       const Gambit::Array<int> &start);
+
+public:
+  DualSimplex(const Gambit::Matrix<T> &A, const Gambit::Vector<T> &b,
+	      const Gambit::Vector<T> &c, int nequals);
+  DualSimplex(const SparseMatrix<T> &A, const Gambit::Vector<T> &b,
+	      const Gambit::Vector<T> &c, int nequals);
+  // the variables j with hasUpper[j] true are bounded above by upper[j]
+  DualSimplex(const SparseMatrix<T> &A, const Gambit::Vector<T> &b,
+	      const Gambit::Vector<T> &c, int nequals,
+	      const Gambit::Array<bool> &hasUpper,
+	      const Gambit::Vector<T> &upper);
+  // start from the basis whose variables are labelled in start
+  DualSimplex(const SparseMatrix<T> &A, const Gambit::Vector<T> &b,
+	      const Gambit::Vector<T> &c, int nequals,
+	      const Gambit::Array<int> &start);
+  ~DualSimplex() { }
+
+  bool IsFeasible(void) const { return m_feasible; }
+  bool IsBounded(void) const { return m_bounded; }
+  long NumPivots(void) const { return m_npivots; }
+
+  // these are only meaningful if the problem is feasible and bounded
+  T OptimumCost(void) const { return m_cost; }
+  const Gambit::Vector<T> &OptimumVector(void) const { return m_primal; }
+  const Gambit::Vector<T> &DualVector(void) const { return m_dual; }
+  const Gambit::Array<int> &GetBasis(void) const { return m_basis; }
+};
+
+//
+// Solves the problem in floating point, and returns the basis found to
+// be optimal, or an empty array if the problem appeared infeasible or
+// unbounded.  Used as the starting basis of an exact solve, this usually
+// leaves only the check that it is optimal, and perhaps a few pivots to
+// repair it, to be done in exact arithmetic.
+//
+template <class T> Gambit::Array<int>
+FloatingPointBasis(const SparseMatrix<T> &A, const Gambit::Vector<T> &b,
+		   const Gambit::Vector<T> &c, int nequals);
+
+#endif  // DUALSIMPLEX_H
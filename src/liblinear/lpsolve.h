@@ -50,12 +50,16 @@ private:
   Gambit::Vector<T> *xx, *cost; 
   Gambit::Vector<T> y, x, d;
 
+  // runs both phases of the simplex method
+  void Compute(const Gambit::Vector<T> &B, const Gambit::Vector<T> &C);
   void Solve(int phase = 0);
   int Enter(void);
   int Exit(int);
 public:
   LPSolve(const Gambit::Matrix<T> &A, const Gambit::Vector<T> &B, const Gambit::Vector<T> &C,
 	  int nequals);   // nequals = number of equalities (last nequals rows)
+  LPSolve(const SparseMatrix<T> &A, const Gambit::Vector<T> &B, 
+	  const Gambit::Vector<T> &C, int nequals);
 //  LPSolve(const Gambit::Matrix<T> &A, const Gambit::Vector<T> &B, 
 //	  const Gambit::Vector<T> &C,  const Gambit::Vector<int> &sense, 
 //	  const Gambit::Vector<int> &LB,  const Gambit::Vector<T> &lb, 
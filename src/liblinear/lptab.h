@@ -46,6 +46,8 @@ public:
   };
   LPTableau(const Gambit::Matrix<T> &A, const Gambit::Vector<T> &b); 
   LPTableau(const Gambit::Matrix<T> &A, const Gambit::Array<int> &art, const Gambit::Vector<T> &b); 
+  LPTableau(const SparseMatrix<T> &A, const Gambit::Vector<T> &b); 
+  LPTableau(const SparseMatrix<T> &A, const Gambit::Array<int> &art, const Gambit::Vector<T> &b); 
   LPTableau(const LPTableau<T>&);
   virtual ~LPTableau();
   
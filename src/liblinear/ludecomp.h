@@ -23,27 +23,47 @@
 #ifndef LUDECOMP_H
 #define LUDECOMP_H
 
+#include <vector>
 #include "libgambit/libgambit.h"
 #include "basis.h"
 
 template <class T> class Tableau;
 
 // ---------------------------------------------------------------------------
-// Class EtaMatrix
+// Class EtaFile
 // ---------------------------------------------------------------------------
 
-template <class T> class EtaMatrix {
-  public:
-  int col;
-  Gambit::Vector<T> etadata;
-  
-  
-  EtaMatrix(int c, Gambit::Vector<T> &v) : col(c), etadata(v) {};
+// A sequence of eta matrices, each the identity with one column replaced.
+// Only the nonzero entries of the replaced columns are kept, one after
+// another in a single array, so that applying the file to a vector touches
+// contiguous memory and skips the zeros.  Etas are indexed from 1.
 
-// required for list class
-bool operator==(const EtaMatrix<T> &) const;
-bool operator!=(const EtaMatrix<T> &) const;
+template <class T> class EtaFile {
+private:
+  std::vector<int> m_col;       // column replaced by each eta
+  std::vector<T> m_pivot;       // diagonal entry of each eta
+  std::vector<int> m_start;     // offset of the entries of each eta
+  std::vector<int> m_index;     // row of each nonzero entry
+  std::vector<T> m_value;       // value of each nonzero entry
 
+public:
+  EtaFile(void) : m_start(1, 0) { }
+
+  int Length(void) const { return m_col.size(); }
+  int NumNonzeros(void) const { return m_index.size(); }
+  void Clear(void);
+
+  // appends the eta whose column c is the vector given
+  void Append(int c, const Gambit::Vector<T> &v);
+
+  int Column(int i) const { return m_col[i-1]; }
+  const T &Pivot(int i) const { return m_pivot[i-1]; }
+  // the nonzero entries of eta i are those from Begin(i) to End(i)-1,
+  // in increasing order of row
+  int Begin(int i) const { return m_start[i-1]; }
+  int End(int i) const { return m_start[i]; }
+  int Index(int k) const { return m_index[k]; }
+  const T &Value(int k) const { return m_value[k]; }
 };
 
 // ---------------------------------------------------------------------------
@@ -57,10 +77,10 @@ private:
   Tableau<T> &tab;
   Basis &basis;
 
-  Gambit::List< EtaMatrix<T> > L;
-  Gambit::List< EtaMatrix<T> > U;
-  Gambit::List< EtaMatrix<T> > E;
-  Gambit::List< int > P;
+  EtaFile<T> L;
+  EtaFile<T> U;
+  EtaFile<T> E;
+  Gambit::Array<int> P;
 
   Gambit::Vector<T> scratch1; // scratch vectors so we don't reallocate them
   Gambit::Vector<T> scratch2; // everytime we do something.
@@ -129,7 +149,9 @@ public:
   void solveT( const Gambit::Vector<T> &, Gambit::Vector <T> & ) const;
 
   // set number of etamatrices added before refactoring;
-  // if number is set to zero, refactoring is done automatically.
+  // if number is set to zero, refactoring is done automatically, when
+  // the etas grow too costly to apply or too dense;
+  // in either case an eta which is numerically unstable forces refactoring.
   // if number is < 0, no refactoring is done;
   void SetRefactor( int );
 
@@ -141,10 +163,10 @@ private:
   
   void FactorBasis();
 
-  void GaussElem( Gambit::Matrix<T> &, int, int );
-
   bool CheckBasis();
   bool RefactorCheck();
+  // number of nonzeros in the factors of the last refactored basis
+  int FactorNonzeros() const;
 
   void BTransE( Gambit::Vector<T> & ) const;
   void FTransE( Gambit::Vector<T> & ) const;
@@ -153,17 +175,12 @@ private:
   void LPd_Trans( Gambit::Vector<T> & ) const;
   void yLP_Trans( Gambit::Vector<T> & ) const;
 
-  void VectorEtaSolve( const Gambit::Vector<T> &v,  
-		      const EtaMatrix<T> &, 
-		      Gambit::Vector<T> &y ) const;
-
-  void EtaVectorSolve( const Gambit::Vector<T> &v, 
-		      const EtaMatrix<T> &,
-		      Gambit::Vector<T> &d ) const;
-
-  void yLP_mult( const Gambit::Vector<T> &y, int j, Gambit::Vector<T> &) const;
+  // these apply eta j of the file given to the vector, in place
+  void VectorEtaSolve( const EtaFile<T> &, int j, Gambit::Vector<T> &y ) const;
+  void EtaVectorSolve( const EtaFile<T> &, int j, Gambit::Vector<T> &d ) const;
 
-  void LPd_mult( Gambit::Vector<T> &d, int j, Gambit::Vector<T> &) const;
+  void yLP_mult( Gambit::Vector<T> &y, int j ) const;
+  void LPd_mult( Gambit::Vector<T> &d, int j ) const;
 
 
 };  // end of class LUdecomp
@@ -0,0 +1,91 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/liblinear/sparse.h
+// Interface to sparse matrix class
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <map>
+#include "libgambit/libgambit.h"
+
+// ---------------------------------------------------------------------------
+// Class SparseMatrix
+// ---------------------------------------------------------------------------
+
+// A matrix which stores only its nonzero entries, column by column.
+// This is used for the constraint matrices of the sequence form, whose
+// nonzeros grow with the size of the game tree rather than with the
+// square of the number of sequences.
+//
+// Entries which have not been set read as zero.  Writing through the
+// non-const operator() creates the entry if it does not yet exist.
+
+template <class T> class SparseMatrix {
+private:
+  int minrow, maxrow, mincol, maxcol;
+  Gambit::Array<std::map<int, T> > columns;
+
+public:
+  typedef typename std::map<int, T>::const_iterator const_iterator;
+
+  // ------------------------
+  // Constructors, Destructor
+  // ------------------------
+
+  // an all-zero matrix with the given index ranges
+  SparseMatrix(int rl, int rh, int cl, int ch);
+  // the nonzero entries of a dense matrix
+  SparseMatrix(const Gambit::Matrix<T> &);
+  ~SparseMatrix() { }
+
+  // --------------------
+  // Public Members
+  // --------------------
+
+  int MinRow(void) const { return minrow; }
+  int MaxRow(void) const { return maxrow; }
+  int MinCol(void) const { return mincol; }
+  int MaxCol(void) const { return maxcol; }
+  int NumRows(void) const { return maxrow - minrow + 1; }
+  int NumColumns(void) const { return maxcol - mincol + 1; }
+  // number of entries stored
+  int NumNonzeros(void) const;
+
+  // check that a vector is indexed by the columns (resp. rows)
+  bool CheckRow(const Gambit::Vector<T> &v) const
+    { return (v.First() == mincol && v.Last() == maxcol); }
+  bool CheckColumn(const Gambit::Vector<T> &v) const
+    { return (v.First() == minrow && v.Last() == maxrow); }
+
+  T operator()(int r, int c) const;
+  T &operator()(int r, int c);
+
+  // the entries stored in a column, in increasing order of row
+  const_iterator Begin(int c) const { return columns[c].begin(); }
+  const_iterator End(int c) const { return columns[c].end(); }
+
+  void GetColumn(int, Gambit::Vector<T> &) const;
+
+  // out = in * A, for a row vector in
+  void RMultiply(const Gambit::Vector<T> &in, Gambit::Vector<T> &out) const;
+};
+
+#endif // SPARSE_H
@@ -41,6 +41,19 @@ Tableau<double>::Tableau(const Gambit::Matrix<double> &A, const Gambit::Array<in
   Solve(b, solution);
 }
 
+Tableau<double>::Tableau(const SparseMatrix<double> &A, const Gambit::Vector<double> &b)
+  : TableauInterface<double>(A,b), B(*this), tmpcol(b.First(),b.Last())
+{
+  Solve(b, solution);
+}
+
+Tableau<double>::Tableau(const SparseMatrix<double> &A, const Gambit::Array<int> &art, 
+			 const Gambit::Vector<double> &b)
+  : TableauInterface<double>(A,art,b), B(*this), tmpcol(b.First(),b.Last())
+{
+  Solve(b, solution);
+}
+
 
 Tableau<double>::Tableau(const Tableau<double> &orig)
   : TableauInterface<double>(orig), B(orig.B,*this), tmpcol(orig.tmpcol)
@@ -190,6 +203,16 @@ Gambit::Integer find_lcd(const Gambit::Vector<Gambit::Rational> &vec)
   return lcd;
 }
 
+Gambit::Integer find_lcd(const SparseMatrix<Gambit::Rational> &mat)
+{
+  Gambit::Integer lcd(1);
+  for(int j=mat.MinCol();j<=mat.MaxCol();j++) 
+    for(SparseMatrix<Gambit::Rational>::const_iterator entry = mat.Begin(j);
+	entry != mat.End(j); entry++)
+      lcd = lcm(entry->second.denominator(),lcd);
+  return lcd;
+}
+
 // Constructors and Destructor
  
 Tableau<Gambit::Rational>::Tableau(const Gambit::Matrix<Gambit::Rational> &A, 
@@ -199,26 +222,7 @@ Tableau<Gambit::Rational>::Tableau(const Gambit::Matrix<Gambit::Rational> &A,
     Coeff(b.First(),b.Last()), denom(1), tmpcol(b.First(),b.Last()), 
     nonbasic(A.MinCol(),A.MaxCol())
 {
-  int j;
-  for(j=MinCol();j<=MaxCol();j++) 
-    nonbasic[j] = j;
-  
-  totdenom = lcm(find_lcd(A),find_lcd(b));
-  if(totdenom<=0) throw BadDenom();
-  
-  for (int i = b.First();i<=b.Last();i++) {
-    Gambit::Rational x = b[i]*(Gambit::Rational)totdenom;
-    if(x.denominator() != 1) throw BadDenom();
-    Coeff[i] = x.numerator();
-  }
-  for (int i = MinRow();i<=MaxRow();i++) 
-    for (int j = MinCol();j<=MaxCol();j++) {
-      Gambit::Rational x = A(i,j)*(Gambit::Rational)totdenom;
-      if(x.denominator() != 1) throw BadDenom();
-      Tabdat(i,j) = x.numerator();
-    }
-  for (int i = b.First();i<=b.Last();i++) 
-    solution[i] = (Gambit::Rational)Coeff[i];
+  Initialize();
 }
 
 Tableau<Gambit::Rational>::Tableau(const Gambit::Matrix<Gambit::Rational> &A, 
@@ -228,29 +232,55 @@ Tableau<Gambit::Rational>::Tableau(const Gambit::Matrix<Gambit::Rational> &A,
     Tabdat(A.MinRow(),A.MaxRow(),A.MinCol(),A.MaxCol()+art.Length()),
     Coeff(b.First(),b.Last()), denom(1), tmpcol(b.First(),b.Last()), 
     nonbasic(A.MinCol(),A.MaxCol()+art.Length())
+{
+  Initialize();
+}
+
+Tableau<Gambit::Rational>::Tableau(const SparseMatrix<Gambit::Rational> &A, 
+			    const Gambit::Vector<Gambit::Rational> &b) 
+  : TableauInterface<Gambit::Rational>(A,b), 
+    Tabdat(A.MinRow(),A.MaxRow(),A.MinCol(),A.MaxCol()),
+    Coeff(b.First(),b.Last()), denom(1), tmpcol(b.First(),b.Last()), 
+    nonbasic(A.MinCol(),A.MaxCol())
+{
+  Initialize();
+}
+
+Tableau<Gambit::Rational>::Tableau(const SparseMatrix<Gambit::Rational> &A, 
+			    const Gambit::Array<int> &art, 
+			    const Gambit::Vector<Gambit::Rational> &b) 
+  : TableauInterface<Gambit::Rational>(A,art,b), 
+    Tabdat(A.MinRow(),A.MaxRow(),A.MinCol(),A.MaxCol()+art.Length()),
+    Coeff(b.First(),b.Last()), denom(1), tmpcol(b.First(),b.Last()), 
+    nonbasic(A.MinCol(),A.MaxCol()+art.Length())
+{
+  Initialize();
+}
+
+void Tableau<Gambit::Rational>::Initialize(void)
 {
   int j;
   for(j=MinCol();j<=MaxCol();j++) 
     nonbasic[j] = j;
   
-  totdenom = lcm(find_lcd(A),find_lcd(b));
+  totdenom = lcm((A) ? find_lcd(*A) : find_lcd(*sparseA),find_lcd(*b));
   if(totdenom<=0) throw BadDenom();
   
-  for (int i = b.First();i<=b.Last();i++) {
-    Gambit::Rational x = b[i]*(Gambit::Rational)totdenom;
+  for (int i = b->First();i<=b->Last();i++) {
+    Gambit::Rational x = (*b)[i]*(Gambit::Rational)totdenom;
     if(x.denominator() != 1) throw BadDenom();
     Coeff[i] = x.numerator();
   }
   for (int i = MinRow();i<=MaxRow();i++) {
-    for (int j = MinCol();j<=A.MaxCol();j++) {
-      Gambit::Rational x = A(i,j)*(Gambit::Rational)totdenom;
+    for (int j = MinCol();j<=MaxCol_A();j++) {
+      Gambit::Rational x = Get_A(i,j)*(Gambit::Rational)totdenom;
       if(x.denominator() != 1) throw BadDenom();
       Tabdat(i,j) = x.numerator();
     }
-    for (int j = A.MaxCol()+1;j<=MaxCol();j++)
+    for (int j = MaxCol_A()+1;j<=MaxCol();j++)
       Tabdat(artificial[j],j) = totdenom;
   }
-  for (int i = b.First();i<=b.Last();i++) 
+  for (int i = b->First();i<=b->Last();i++) 
     solution[i] = (Gambit::Rational)Coeff[i];
 }
 
@@ -437,7 +467,7 @@ void Tableau<Gambit::Rational>::Refactor()
   //BigDump(gout);
   //** Note -- we may need to recompute totdenom here, if A and b have changed. 
   //gout << "\ndenom: " << denom << " totdenom: " << totdenom;
-  totdenom = lcm(find_lcd(*A),find_lcd(*b));
+  totdenom = lcm((A) ? find_lcd(*A) : find_lcd(*sparseA),find_lcd(*b));
   if(totdenom<=0) throw BadDenom();
   // gout << "\ndenom: " << denom << " totdenom: " << totdenom;
 
@@ -482,13 +512,25 @@ void Tableau<Gambit::Rational>::SetConst(const Gambit::Vector<Gambit::Rational>
 }
 
 
-//** this function is not currently used.  Drop it?
+// Pivots to the basis whose labels are those of in, though not
+// necessarily in the same rows.  Each label not yet basic is pivoted
+// into a row whose label is not in the new basis; if there is none
+// with a nonzero entry, the new basis is singular.
 void Tableau<Gambit::Rational>::SetBasis(const Basis &in)
 {
-  basis= in;
-  //** this has to be changed -- Need to start over and pivot to new basis.  
-  // B.refactor();
-  // B.solve(*b, solution);
+  for (int i = in.First(); i <= in.Last(); i++) {
+    int label = in.Label(i);
+    if (Member(label))  continue;
+    MySolveColumn(label, tmpcol);
+    int row = 0;
+    for (int j = MinRow(); j <= MaxRow() && row == 0; j++) {
+      if (tmpcol[j] != (Gambit::Rational) 0 && !in.Member(Label(j))) {
+	row = j;
+      }
+    }
+    if (row == 0)  throw BadPivot();
+    Pivot(row, label);
+  }
 }
 
  // solve M x = b
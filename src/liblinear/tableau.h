@@ -50,6 +50,9 @@ public:
   Tableau(const Gambit::Matrix<double> &A, const Gambit::Vector<double> &b); 
   Tableau(const Gambit::Matrix<double> &A, const Gambit::Array<int> &art, 
 	  const Gambit::Vector<double> &b); 
+  Tableau(const SparseMatrix<double> &A, const Gambit::Vector<double> &b); 
+  Tableau(const SparseMatrix<double> &A, const Gambit::Array<int> &art, 
+	  const Gambit::Vector<double> &b); 
   Tableau(const Tableau<double>&);
   virtual ~Tableau();
   
@@ -93,6 +96,7 @@ private:
   Gambit::Vector<Gambit::Rational> tmpcol; // temporary column vector, to avoid allocation
 
   void MySolveColumn(int, Gambit::Vector<Gambit::Rational> &);  // column in new basis 
+  void Initialize(void);  // fills in the tableau from A and b
 
 protected:
   Gambit::Array<int> nonbasic;     //** nonbasic variables -- should be moved to Basis
@@ -107,6 +111,10 @@ public:
   Tableau(const Gambit::Matrix<Gambit::Rational> &A, const Gambit::Vector<Gambit::Rational> &b); 
   Tableau(const Gambit::Matrix<Gambit::Rational> &A, const Gambit::Array<int> &art, 
 	  const Gambit::Vector<Gambit::Rational> &b); 
+  Tableau(const SparseMatrix<Gambit::Rational> &A, 
+	  const Gambit::Vector<Gambit::Rational> &b); 
+  Tableau(const SparseMatrix<Gambit::Rational> &A, const Gambit::Array<int> &art, 
+	  const Gambit::Vector<Gambit::Rational> &b); 
   Tableau(const Tableau<Gambit::Rational>&);
   virtual ~Tableau();
   
@@ -134,4 +142,33 @@ public:
   Gambit::Integer TotDenom() const;
 };
 
+//
+// Pivots p_tableau to the basis made up of those variables in p_labels
+// which are columns of it, for example to reproduce in exact arithmetic
+// a basis found in floating point.  Each such variable not yet basic
+// replaces one which is not in p_labels, in whichever row the tableau
+// chooses.  Throws BadPivot if the basis is singular.
+//
+template <class T> 
+void PivotToBasis(Tableau<T> &p_tableau, const Gambit::Array<int> &p_labels)
+{
+  Basis basis(p_tableau.GetBasis());
+  int row = basis.First();
+  for (int i = 1; i <= p_labels.Length(); i++) {
+    int label = p_labels[i];
+    if ((!basis.IsRegColumn(label) && !basis.IsSlackColumn(label)) ||
+	basis.Member(label)) {
+      continue;
+    }
+    while (row <= basis.Last() && p_labels.Contains(basis.Label(row))) {
+      row++;
+    }
+    if (row > basis.Last()) {
+      throw typename Tableau<T>::BadPivot();
+    }
+    basis.Pivot(row, label);
+  }
+  p_tableau.SetBasis(basis);
+}
+
 #endif     // TABLEAU_H
@@ -183,3 +183,32 @@ class ExternalLogitSolver(ExternalSolver):
         return self._parse_output(self.launch(command_line, game),
                                   game, rational,
                                   extensive=game.is_tree and not use_strategic)
+
+    def solve_batch(self, games, use_strategic=False):
+        """
+        Compute equilibria for each of a sequence of games, using a
+        single call to gambit-logit in batch mode.  Returns a list
+        giving the list of equilibria found for each game in turn.
+        """
+        command_line = "gambit-logit -d 20 -e -B"
+        if use_strategic:
+            command_line += " -S"
+        p = subprocess.Popen("%s -q" % command_line, shell=True,
+                             stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                             close_fds=True)
+        for game in games:
+            if game.is_tree:
+                p.stdin.write(game.write(strategic=False))
+            else:
+                p.stdin.write(game.write(strategic=True))
+        p.stdin.close()
+
+        # Each line of output is tagged with the (1-based) index of the game
+        results = [ [ ] for game in games ]
+        for line in p.stdout:
+            index, entries = line.split(",", 1)
+            game = games[int(index)-1]
+            results[int(index)-1] += \
+                self._parse_output([ entries ], game, rational=False,
+                                   extensive=game.is_tree and not use_strategic)
+        return results
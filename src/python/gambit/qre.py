@@ -3,6 +3,8 @@ A set of utilities for computing and analyzing quantal response equilbria
 """
 
 import math
+import os
+import tempfile
 import numpy
 import pctrace
 
@@ -232,9 +234,17 @@ class ExternalStrategicQREPathTracer(ExternalSolver):
     Algorithm class to manage calls to external gambit-logit solver
     for tracing a branch of the logit QRE correspondence.
     """
-    def trace_strategic_path(self, game, max_lambda=1000000.0):
+    def trace_strategic_path(self, game, max_lambda=1000000.0,
+                             branch_file=None):
+        """
+        Trace the principal branch up to max_lambda.  If branch_file
+        is given, the branch is also saved to that file, for use in
+        later calls to compute_at_lambda().
+        """
         profiles = [ ]
         command_line = "gambit-logit -d 20 -m %f" % max_lambda
+        if branch_file is not None:
+            command_line += " -w '%s'" % branch_file
         for line in self.launch(command_line, game):
             entries = line.strip().split(",")
             profile = game.mixed_profile()
@@ -243,8 +253,17 @@ class ExternalStrategicQREPathTracer(ExternalSolver):
             profiles.append(LogitQRE(float(entries[0]), profile))
         return profiles
         
-    def compute_at_lambda(self, game, lam):
-        command_line = "gambit-logit -d 20 -l %f" % lam
+    def compute_at_lambda(self, game, lam, branch_file=None):
+        """
+        Compute the QRE on the principal branch at lam.  If branch_file
+        names a branch saved by trace_strategic_path(), the QRE is
+        interpolated along the saved branch rather than traced.
+        """
+        if branch_file is not None:
+            command_line = "gambit-logit -d 20 -r '%s' -f %f" % \
+                           (branch_file, lam)
+        else:
+            command_line = "gambit-logit -d 20 -l %f" % lam
         line = list(self.launch(command_line, game))[-1]
         entries = line.strip().split(",")
         profile = game.mixed_profile()
@@ -253,4 +272,30 @@ class ExternalStrategicQREPathTracer(ExternalSolver):
         return [ LogitQRE(float(entries[0]), profile) ]
         
 
-
+    def compute_max_like(self, game, data):
+        """
+        Estimate lambda by maximum likelihood given the observed counts
+        of play of each strategy in 'data'.  The branch is traced and
+        the likelihood maximized in a single call to gambit-logit.
+        Returns the QRE at the estimate, with the log-likelihood and the
+        standard error of lambda as attributes logL and std_err.
+        """
+        (fd, filename) = tempfile.mkstemp()
+        try:
+            f = os.fdopen(fd, "w")
+            f.write(",".join([ str(x) for x in data ]) + "\n")
+            f.close()
+            command_line = "gambit-logit -d 20 -S -E -L '%s'" % filename
+            lines = list(self.launch(command_line, game))
+        finally:
+            os.remove(filename)
+        if len(lines) == 0:
+            return None
+        entries = lines[-1].strip().split(",")
+        profile = game.mixed_profile()
+        for (i, p) in enumerate(entries[1:-2]):
+            profile[i] = float(p)
+        qre = LogitQRE(float(entries[0]), profile)
+        qre.logL = float(entries[-2])
+        qre.std_err = float(entries[-1])
+        return qre
@@ -3,7 +3,7 @@
 // Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
 //
 // FILE: src/tools/enummixed/clique.cc
-// Maximal cliques and solution components via von Stengel's algorithm
+// Maximal cliques and connected components of bipartite graphs
 //
 // This program is free software; you can redistribute it and/or modify
 // it under the terms of the GNU General Public License as published by
@@ -20,6 +20,8 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <algorithm>
+#include <set>
 #include "clique.h"
 #include "libgambit/libgambit.h"
 
@@ -30,20 +32,22 @@
 
 int main()
 {
-  gArray<edge> edgelist1(MAXEDGES);
+  List<edge> edges;
   
-  int i,j, count = 0;
+  int i,j, maxinp1 = 0, maxinp2 = 0;
   while (scanf("%d %d", &i, &j) != EOF) {
-    count ++;
-    edgelist1[count].node1=i;
-    edgelist1[count].node2=j;
+    edge e;
+    e.node1 = i;
+    e.node2 = j;
+    edges.Append(e);
+    maxinp1 = std::max(maxinp1, i+1);
+    maxinp2 = std::max(maxinp2, j+1);
   }
-  gArray<edge> edgelist(count);
-  for(int i=1;i<=count;i++) {
-    edgelist[i].node1 = edgelist1[i].node1;
-    edgelist[i].node2 = edgelist1[i].node2;
+  Array<edge> edgelist(edges.Length());
+  for(int i=1;i<=edges.Length();i++) {
+    edgelist[i] = edges[i];
   }
-  EnumCliques clique(edgelist,MAXINP1,MAXINP2);
+  EnumCliques clique(edgelist,maxinp1,maxinp2);
   return 1 ;
 }
 
@@ -51,619 +55,567 @@ int main()
 #endif
 
 // -------------------------------------------------- 
+// NodeSet
 
-EnumCliques::EnumCliques(Gambit::Array<edge> &edgelist,int maxinp1,int maxinp2 ) 
-  : firstedge(MIN(maxinp1,maxinp2)+1), maxinp1(maxinp1), maxinp2(maxinp2)
+// the position of the lowest set bit of x, which is nonzero
+static inline int LowestBit(unsigned long x)
 {
-  int numco = getconnco(firstedge, edgelist);
-  workonco(numco, firstedge, edgelist) ;
-  
+#ifdef __GNUC__
+  return __builtin_ctzl(x);
+#else
+  int bit = 0;
+  for (; !(x & 1UL); x >>= 1)  bit++;
+  return bit;
+#endif  // __GNUC__
 }
 
-EnumCliques::~EnumCliques()
+// the number of bits set in x
+static inline int CountBits(unsigned long x)
 {
+#ifdef __GNUC__
+  return __builtin_popcountl(x);
+#else
+  int count = 0;
+  for (; x; x &= x - 1)  count++;
+  return count;
+#endif  // __GNUC__
 }
 
-void EnumCliques::
-candtry1 (int stk[], // stack 
-	  bool connected[MAXM][MAXN],
-	  int cand,  // the candidate from NODES1  to be added to CLIQUE 
-	  int clique1[], int cliqsize1,  // CLIQUE so far in NODES1 
-	  int clique2[], int cliqsize2,  // CLIQUE so far in NODES2 
-	  int sn1, int *sc1, int ec1,   // start NOT1, start CAND1, end CAND1 
-	  int sn2, int sc2, int ec2,   // start NOT2, start CAND2, end CAND2 
-	  int tos,  // top of stack 
-	  int orignode1[MAXM],
-	  int orignode2[MAXN]
-	  )
-  /* recurses down by moving  cand  from  CAND1  to  clique1  and
-     then to NOT1  after extension.
-     clique1  is extended by  cand  where all points in  NOT2 and CAND2 
-     relate to  cand.
-     pre:  cand  is in CAND1
-     post: cand  is moved from  CAND1  to  NOT1
-     CAND1 may be shuffled,  o/w stack unchanged 
-  */
+int NodeSet::Next(int p_node) const
 {
-  int i, j, snnew, scnew, ecnew;
-  
-  clique1[cliqsize1++] = cand ;
-  // remove  cand  from CAND1 by replacing it with the last element of CAND1 
-  for (i=*sc1; i<ec1; i++)
-      if (cand == stk[i]) {
-         stk[i] = stk[--ec1] ;
-         break ;
-         }
-  // stk[ec1] is free now but will after extension be needed again 
-  // fill new sets NOT2, CAND2 
-  snnew = tos ;
-  for (j=sn2; j<sc2; j++) 
-    if (connected[cand][stk[j]])
-      stk[tos++] = stk[j] ;
-  scnew = tos ;
-  for (j=sc2; j<ec2; j++) 
-    if (connected[cand][stk[j]])
-      stk[tos++] = stk[j] ;
-  ecnew = tos ;
-  
-  extend(stk, connected, clique1, cliqsize1, clique2, cliqsize2,
-	 sn1, *sc1, ec1, snnew, scnew, ecnew, tos, orignode1, orignode2);
-  
-  /* remove  cand  from  clique1,
-     put  cand  into  NOT1  by increasing  *sc1  and moving
-     the node at position  *sc1  to the end of CAND1 */
-  // The following lines modified since ec1 and cliqsize1 are
-  // never used after the increments
-  //cliqsize1-- ;
-  //stk[ec1++] = stk[*sc1] ;
-  stk[ec1] = stk[*sc1];
-  stk[*sc1] = cand ;
-  (*sc1)++ ;
+  unsigned int w = p_node / s_wordBits;
+  if (w >= m_bits.size())  return -1;
+  unsigned long word = m_bits[w] & (~0UL << (p_node % s_wordBits));
+  while (!word) {
+    if (++w == m_bits.size())  return -1;
+    word = m_bits[w];
+  }
+  return w * s_wordBits + LowestBit(word);
 }
 
-// -------------------------------------------------- 
-void EnumCliques::
-candtry2 (int stk[], // stack 
-	  bool connected[MAXM][MAXN],
-	  int cand,  // the candidate from NODES2  to be added to CLIQUE 
-	  int clique1[], int cliqsize1,  // CLIQUE so far in NODES1 
-	  int clique2[], int cliqsize2,  // CLIQUE so far in NODES2 
-	  int sn1, int sc1, int ec1,   // start NOT1, start CAND1, end CAND1 
-	  int sn2, int *sc2, int ec2,   // start NOT2, start CAND2, end CAND2 
-	  int tos,  // top of stack 
-	  int orignode1[MAXM],
-	  int orignode2[MAXN]
-	  )
-  // recurses down by moving  cand  from  CAND2  to  clique2  and
-  // then to NOT2  after extension;
-  // clique2  is extended by  cand  where all points in  NOT1 and CAND1 
-  // relate to  cand.
-  // pre:  cand  is in CAND2
-  // post: cand  is moved from  CAND2  to  NOT2
-  // CAND2 may be shuffled,  o/w stack unchanged
-  
+int NodeSet::CountCommon(const NodeSet &p_set) const
 {
-  int i, j,  snnew, scnew, ecnew;
-  
-  clique2[cliqsize2++] = cand ;
-  // remove  cand  from CAND2 by replacing it with the last element of CAND2 
-  for (j=*sc2; j<ec2; j++)
-      if (cand == stk[j]) {
-	 stk[j] = stk[--ec2] ;
-	 break ;
-	 }
-  // stk[ec2] is free now but will after extension be needed again 
-  // fill new sets NOT1, CAND1 
-  snnew = tos ;
-  for (i=sn1; i<sc1; i++) 
-    if (connected[stk[i]][cand])
-      stk[tos++] = stk[i] ;
-  scnew = tos ;
-  for (i=sc1; i<ec1; i++) 
-    if (connected[stk[i]][cand])
-      stk[tos++] = stk[i] ;
-  ecnew = tos ;
-  
-  extend(stk, connected, clique1, cliqsize1, clique2, cliqsize2,
-	 snnew, scnew, ecnew, sn2, *sc2, ec2, tos, orignode1, orignode2);
-  
-  // remove  cand  from  clique2,
-  // put  cand  into  NOT2  by increasing  *sc2  and moving
-  // the node at position  sc2  to the end of CAND1 
-
-  // The following lines modified since ec2 and cliqsize2 are not used
-  // after the increments
-  // cliqsize2-- ;
-  // stk[ec2++] = stk[*sc2] ;
-  stk[ec2] = stk[*sc2];
-  stk[*sc2] = cand ;
-  (*sc2)++ ;
+  int count = 0;
+  for (unsigned int w = 0; w < m_bits.size(); w++) {
+    count += CountBits(m_bits[w] & p_set.m_bits[w]);
+  }
+  return count;
+}
+
+int NodeSet::Intersect(const NodeSet &p_set1, const NodeSet &p_set2)
+{
+  int count = 0;
+  m_bits.resize(p_set1.m_bits.size());
+  for (unsigned int w = 0; w < m_bits.size(); w++) {
+    m_bits[w] = p_set1.m_bits[w] & p_set2.m_bits[w];
+    count += CountBits(m_bits[w]);
+  }
+  return count;
 }
 
 // -------------------------------------------------- 
-void EnumCliques::
-extend (int stk[], // stack 
-	bool connected[MAXM][MAXN],
-	int clique1[], int cliqsize1,  // CLIQUE so far in NODES1 
-	int clique2[], int cliqsize2,  // CLIQUE so far in NODES2 
-	int sn1, int sc1, int ec1,   // start NOT1, start CAND1, end CAND1 
-	int sn2, int sc2, int ec2,   // start NOT2, start CAND2, end CAND2 
-	int tos,   // top of stack,   tos >= ec1, ec2  
-	int orignode1[MAXM],   // original node numbers as input 
-	int orignode2[MAXN]
-	)
-  /* extends the current set CLIQUE or outputs it if
-     NOT and CAND are empty.
-     
-     pre:  CLIQUE = clique1[0, cliqsize1], clique2[0, cliqsize2]
-     NOT1 = stk[sn1, sc1],  CAND1= stk[sc1, ec1]   
-     NOT2 = stk[sn2, sc2],  CAND2= stk[sc2, ec2]   
-     sn1 <= sc1 <= ec1, sn2 <= sc2 <= ec2 
-     all cliques extending  CLIQUE
-     containing a node in  NOT1  or  NOT2  have already been generated
-     post: output of all maximal cliques extending  CLIQUE  with
-     candidates from  CAND1  or  CAND2  but not from NOT1, NOT2.
-  */
+// EnumCliques
+
+// the representative of the component of node x, halving the path to it
+static int FindRoot(Array<int> &parent, int x)
 {
-  /* if no further extension is possible then  
-     output the current CLIQUE if applicable, and return */
-  
-  if (sc1 == ec1 && sc2 == ec2) {
-    //  CAND is empty  
-    if (sn1 == sc1 && sn2 == sc2)
-      //  NOT is empty, otherwise do nothing  
-      outCLIQUE(clique1, cliqsize1, clique2, cliqsize2,
-                orignode1, orignode2) ;
+  while (parent[x] != x) {
+    parent[x] = parent[parent[x]];
+    x = parent[x];
   }
-  
-  else {  //  CAND not empty 
-    int cmax;  // maximal number of candidates on either side  
-    int firstlist, savelist, tmplist, posfix ; // stack positions 
-    int fixp;  // the fixpoint 
-    int minnod ;
-    bool bfound, bfixin1, bcandfix;
-    
-    cmax = MAX(ec1-sc1, ec2-sc2);  // the larger of |CAND1|, |CAND2|  
-    
-    // reserve two arrays of size cmax on the stack 
-    firstlist = tmplist = tos;  tos += cmax;
-    savelist = tos;  
-
-    // tos is not used again.. 
-    // tos += cmax;
-    
-    /* find fixpoint  fixp (a node of the graph) in  NOT  or  CAND
-       which has the smallest possible number of disconnections  minnod 
-       to CAND  */
-    minnod = cmax + 1 ;
-    
-    // look for  fixp  in NODES1  
-    findfixpoint(stk, connected, &savelist, &tmplist, &minnod,
-		 sn1, ec1, sc2, ec2, 1, &bfixin1, &fixp, &posfix) ;
-    bcandfix = (posfix >= sc1);
-    
-    // look for  fixp  in nodes2  
-    findfixpoint(stk, connected, &savelist, &tmplist, &minnod,
-		 sn2, ec2, sc1, ec1, 0, &bfound, &fixp, &posfix) ;
-    
-    if (bfound) {
-      bfixin1 = false ;
-      bcandfix = (posfix >= sc2);
+  return x;
+}
+
+EnumCliques::EnumCliques(const Array<edge> &edgelist, 
+			 int maxinp1, int maxinp2) 
+  /* finds the connected components by union-find, with left node  i
+     numbered  i  and right node  j  numbered  maxinp1 + j,  and works
+     on the edges of each, in the order of the first edge of each in
+     the input
+     pre:  nodes are nonnegative integers < maxinp1,2;
+     other edges are rejected with a warning msg.
+  */
+{
+  Array<int> parent(0, maxinp1 + maxinp2 - 1);
+  for (int i = 0; i < maxinp1 + maxinp2; i++)  parent[i] = i;
+
+  std::vector<int> edges;
+  for (int e = 1; e <= edgelist.Length(); e++) {
+    int i = edgelist[e].node1, j = edgelist[e].node2;
+    if (i < 0 || i>= maxinp1 || j<0 || j>=maxinp2) {
+      printf("Edge (%d, %d) not in admitted range (0..%d, 0..%d), rejected\n",
+	     i,j, maxinp1-1, maxinp2-1) ;
     }
-    
-    /* now:  fixp     = the node that is the fixpoint,
-       posfix   = its position on the stack,
-       bfixin1  = fixp  is in NODES1
-       bcandfix = fixp  is a candidate
-       stk[savelist, +minnod] = nodes disconnected to fixp
-       which are all either in CAND1 or in CAND2;
-    */
-    /*    top of stack can be reset to  savelist+minnod  where
-	  if savelist  is the second of the two lists, recopy it
-	  to avoid that stk[firstlist, +cmax] is wasted
-    */
-    if (savelist != firstlist) {int i;
-    for (i=0; i < minnod; i++) 
-      stk[firstlist + i] = stk[savelist + i];
-    savelist = firstlist ;
+    else {
+      edges.push_back(e);
+      parent[FindRoot(parent, i)] = FindRoot(parent, maxinp1 + j);
     }
-    tos = savelist + minnod;
-    
-    if (bfixin1) {int j;  // fixpoint in NODES1  
-    if (bcandfix)      // fixpoint is a candidate 
-      candtry1(stk, connected, fixp, 
-	       clique1, cliqsize1, clique2, cliqsize2,
-	       sn1, &sc1, ec1, sn2, sc2, ec2, tos, orignode1, orignode2);
-    // fixpoint is now in NOT1, try all the nodes disconnected to it 
-    for (j=0; j<minnod;  j++) 
-      candtry2(stk, connected, stk[savelist+j],
-	       clique1, cliqsize1, clique2, cliqsize2,
-	       sn1, sc1, ec1, sn2, &sc2, ec2, tos, orignode1, orignode2);
+  }
+
+  Array<int> co(0, maxinp1 + maxinp2 - 1);
+  for (int i = 0; i < maxinp1 + maxinp2; i++)  co[i] = 0;
+  std::vector<std::vector<int> > coedges;
+  for (unsigned int k = 0; k < edges.size(); k++) {
+    int root = FindRoot(parent, edgelist[edges[k]].node1);
+    if (co[root] == 0) {
+      coedges.push_back(std::vector<int>());
+      co[root] = coedges.size();
+    }
+    coedges[co[root] - 1].push_back(edges[k]);
+  }
+
+  for (unsigned int c = 0; c < coedges.size(); c++) {
+    workonco(coedges[c], edgelist);
+  }
+}
+
+EnumCliques::~EnumCliques()
+{
+}
+
+// orders the cliques stored from the given positions in  m_found 
+// lexicographically, by their nodes in NODES1, then in NODES2
+class CliqueLess {
+private:
+  const std::vector<int> &m_found;
+
+public:
+  CliqueLess(const std::vector<int> &p_found) : m_found(p_found) { }
+
+  bool operator()(int p_start1, int p_start2) const
+  {
+    const int *c1 = &m_found[p_start1], *c2 = &m_found[p_start2];
+    const int *end1 = c1 + 2 + c1[0], *end2 = c2 + 2 + c2[0];
+    if (std::lexicographical_compare(c1 + 2, end1, c2 + 2, end2)) {
+      return true;
     }
-    else {int j;          // fixpoint in NODES2  
-    if (bcandfix)      // fixpoint is a candidate 
-      candtry2(stk, connected, fixp,
-	       clique1, cliqsize1, clique2, cliqsize2,
-	       sn1, sc1, ec1, sn2, &sc2, ec2, tos, orignode1, orignode2);
-    // fixpoint is now in NOT2, try all the nodes disconnected to it 
-    for (j=0; j<minnod;  j++) 
-      candtry1(stk, connected, stk[savelist+j],
-	       clique1, cliqsize1, clique2, cliqsize2,
-	       sn1, &sc1, ec1, sn2, sc2, ec2, tos, orignode1, orignode2);
+    if (std::lexicographical_compare(c2 + 2, end2, c1 + 2, end1)) {
+      return false;
     }
-  }  // end candidates not empty 
-} 
+    return std::lexicographical_compare(end1, end1 + c1[1], 
+					end2, end2 + c2[1]);
+  }
+};
 
 // -------------------------------------------------- 
-void EnumCliques::
-findfixpoint(int stk[], // stack 
-	     bool connected[MAXM][MAXN],
-	     int *savelist,      // position of savelist on the stack 
-	     int *tmplist,       // position of tmplist on the stack 
-	     // might be swapped afterwards 
-	     int *minnod,        // currently lowest no. of disconnections 
-	     int sninspect, int ecinspect, /* range of stack positions
-					      containing the nodes inspected 
-					      as possible fixpoints */
-	     int scother, int ecother,
-	     // range of corresponding candidates on the other side  
-	     bool binspect1,  // inspected nodes are in class1, o/w class2 
-	     bool *bfound,  // a new lower no. of disconnections was found 
-	     int *fixp,     // the new fixpoint, if *bfound = true  
-	     int *posfix    // position of fixpoint on the stack, if *bfound 
-	     )
-  /* pre:  enough space on stack for the two lists  savelist,  tmplist
-     post: *minnod contains the new minimum no. of disconnections
-     stk[*savelist, +*minnod] contains the candidates disconnected to
-     the fixpoint
+void EnumCliques::workonco(const std::vector<int> &p_edges,
+			   const Array<edge> &p_edgelist)
+  /* computes the maximal cliques of the component with the given
+     edges, appending them to  m_cliques1, m_cliques2
   */
 {
-  int i,j, p ;
-  int count ;
-  int tmp ;
-  *bfound = false ;
-  
-  for (i=sninspect; i<ecinspect; i++) {
-    p = stk[i] ;
-    count = 0;
-    /* count number of disconnections to  p,  
-       building up stk[tmplist+count] containing the
-       disconnected points */
-    for (j=scother; (j<ecother) && (count < *minnod); j++) {
-      int k = stk[j] ;
-      if (!( binspect1 ? connected[p][k] : connected[k][p] )) {
-         stk[(*tmplist) + count] = k ;
-         count ++ ;
+  m_orignode1.clear();
+  m_orignode2.clear();
+  for (unsigned int k = 0; k < p_edges.size(); k++) {
+    m_orignode1.push_back(p_edgelist[p_edges[k]].node1);
+    m_orignode2.push_back(p_edgelist[p_edges[k]].node2);
+  }
+  std::sort(m_orignode1.begin(), m_orignode1.end());
+  m_orignode1.erase(std::unique(m_orignode1.begin(), m_orignode1.end()),
+		    m_orignode1.end());
+  std::sort(m_orignode2.begin(), m_orignode2.end());
+  m_orignode2.erase(std::unique(m_orignode2.begin(), m_orignode2.end()),
+		    m_orignode2.end());
+  m_m = m_orignode1.size();
+  m_n = m_orignode2.size();
+
+  m_adj1.assign(m_m, std::vector<int>());
+  m_adj2.assign(m_n, std::vector<int>());
+  for (unsigned int k = 0; k < p_edges.size(); k++) {
+    const edge &e = p_edgelist[p_edges[k]];
+    int i = std::lower_bound(m_orignode1.begin(), m_orignode1.end(),
+			     e.node1) - m_orignode1.begin();
+    int j = std::lower_bound(m_orignode2.begin(), m_orignode2.end(),
+			     e.node2) - m_orignode2.begin();
+    m_adj1[i].push_back(j);
+    m_adj2[j].push_back(i);
+  }
+  // an edge may appear more than once in the input
+  for (int i = 0; i < m_m; i++) {
+    std::sort(m_adj1[i].begin(), m_adj1[i].end());
+    m_adj1[i].erase(std::unique(m_adj1[i].begin(), m_adj1[i].end()),
+		    m_adj1[i].end());
+  }
+  for (int j = 0; j < m_n; j++) {
+    std::sort(m_adj2[j].begin(), m_adj2[j].end());
+    m_adj2[j].erase(std::unique(m_adj2[j].begin(), m_adj2[j].end()),
+		    m_adj2[j].end());
+  }
+
+  // at most 32 megabytes are used for the bitsets of neighbours
+  m_nbrs1.clear();
+  m_nbrs2.clear();
+  if (((double) m_m * NodeSet(m_n).NumWords() + 
+       (double) m_n * NodeSet(m_m).NumWords()) * sizeof(unsigned long) <=
+      (double) (1 << 25)) {
+    m_nbrs1.assign(m_m, NodeSet(m_n));
+    m_nbrs2.assign(m_n, NodeSet(m_m));
+    for (int j = 0; j < m_n; j++) {
+      for (unsigned int k = 0; k < m_adj2[j].size(); k++) {
+	m_nbrs1[m_adj2[j][k]].Insert(j);
+	m_nbrs2[j].Insert(m_adj2[j][k]);
       }
-    }  // end loop j, comparing to other side 
-    // check if new minimum found, in that case update fixpoint 
-    if (count < *minnod) {
-      *fixp = p ;
-      *posfix = i;
-      *minnod = count ;
-      // save tmplist by making it the new savelist 
-      tmp = *savelist ;
-      *savelist = *tmplist;
-      *tmplist  = tmp ;
-      *bfound = true ;
     }
-  }  // end loop  i,  inspecting nodes for fixpoint  
-}
+    m_tried.Clear(m_n);
+  }
 
-// -------------------------------------------------- 
-void EnumCliques::genincidence(
-			       int e,
-			       Gambit::Array<edge> &edgelist,
-			       int orignode1[MAXM],
-			       int orignode2[MAXN],
-			       bool connected[MAXM][MAXN],
-			       int *m,
-			       int *n
-			       )
-  /* generates the incidence matrix  connected from the edgelist
-     starting with edgelist[e]
-     pre:  all nodes in edgelist < maxinp1,2
-     post: orignode1[0..*m) contains the original node1 numbers
-     orignode2[0..*n) contains the original node2 numbers
-     connected[][] == true if edge, o/w false
-     *m == number of rows 
-     *n == number of columns
-     */
-{
-  Gambit::Array<int> newnode1(0,maxinp1-1) ;
-  Gambit::Array<int> newnode2(0,maxinp2-1) ;
-  int i,j, newi, newj ;
-  
-  // init newnode 
-  for (i=0; i<maxinp1; i++)  newnode1[i] = -1;
-  for (j=0; j<maxinp2; j++)  newnode2[j] = -1;
-  
-  /* init connected for test ; note different dimension 
-     for (i=0; i<MAXM; i++)
-     for (j=0; j<MAXN; j++)  connected[i][j] = 2;    
-  */
-  
-  *m = *n = 0;
-  
-  while (e) { // process the edge list with edge index e 
-    i= edgelist[e].node1;
-    j= edgelist[e].node2;
-    newi = newnode1[i] ;
-    newj = newnode2[j] ;
-    if (newi == -1) {
-      if (*m >= MAXM) { // out of bounds for connected, reject 
-	printf("Left bound %d for incidence matrix ", MAXM ) ;
-	printf("reached, edge (%d, %d) rejected\n", i, j);
-	goto KEEPGOING ;
+  std::vector<int> nodeorder, position(m_n);
+  order(nodeorder);
+  for (int k = 0; k < m_n; k++)  position[nodeorder[k]] = k;
+
+  m_found.clear();
+  m_starts.clear();
+  m_levels.resize(1);
+  std::vector<int> seen(m_n, -1), cand, notset;
+  for (int k = 0; k < m_n; k++) {
+    int v = nodeorder[k];
+    CliqueLevel &level = m_levels[0];
+    level.clique1.Clear(m_m);
+    for (unsigned int i = 0; i < m_adj2[v].size(); i++) {
+      level.clique1.Insert(m_adj2[v][i]);
+    }
+    level.cliqsize1 = m_adj2[v].size();
+
+    /* a node of NOT connected to all of U is a neighbour of each node
+       of U, in particular of the one with fewest neighbours, so check
+       for one before looking further */
+    bool maximal = true;
+    if (!m_nbrs1.empty()) {
+      maximal = !covered(level.clique1);
+    }
+    else {
+      int fewest = m_adj2[v][0];
+      for (unsigned int i = 1; i < m_adj2[v].size(); i++) {
+	if (m_adj1[m_adj2[v][i]].size() < m_adj1[fewest].size()) {
+	  fewest = m_adj2[v][i];
+	}
       }
-      else {
-	int k;
-	newi = (*m) ++ ;
-	// init connected on the fly 
-	for (k=0; k<MAXN; k++)  connected[newi][k] = false;
-	newnode1[i] = newi ;
-	orignode1[newi] = i ;
+      for (unsigned int j = 0; maximal && j < m_adj1[fewest].size(); j++) {
+	int w = m_adj1[fewest][j];
+	maximal = (position[w] >= k || 
+		   countconn(w, level.clique1) < level.cliqsize1);
       }
     }
-    if (newj == -1) {
-      if (*n >= MAXN) { // out of bounds for connected, reject 
-	printf("Right bound %d for incidence matrix ", MAXN ) ;
-	printf("reached, edge (%d, %d) rejected\n", i, j);
-	goto KEEPGOING ;
-      }
-      else {
-	newj = (*n) ++ ;
-	newnode2[j] = newj ;
-	orignode2[newj] = j ;
+    if (!maximal) {
+      if (!m_nbrs1.empty())  m_tried.Insert(v);
+      continue;
+    }
+
+    // CAND and NOT are the later and earlier nodes sharing a neighbour
+    cand.clear();
+    notset.clear();
+    seen[v] = v;
+    for (unsigned int i = 0; i < m_adj2[v].size(); i++) {
+      const std::vector<int> &adj = m_adj1[m_adj2[v][i]];
+      for (unsigned int j = 0; j < adj.size(); j++) {
+	if (seen[adj[j]] != v) {
+	  seen[adj[j]] = v;
+	  if (position[adj[j]] > k) {
+	    cand.push_back(adj[j]);
+	  }
+	  else if (m_nbrs1.empty()) {
+	    notset.push_back(adj[j]);
+	  }
+	}
       }
     }
-    connected[newi][newj] = true ;
-    
-  KEEPGOING:
-    e = edgelist[e].nextedge ;
+    m_clique2.assign(1, v);
+    extend(0, cand, notset, -1);
+    if (!m_nbrs1.empty())  m_tried.Insert(v);
+  }
+
+  std::sort(m_starts.begin(), m_starts.end(), CliqueLess(m_found));
+  for (unsigned int c = 0; c < m_starts.size(); c++) {
+    const int *clique = &m_found[m_starts[c]];
+    Array<int> cliq1(clique[0]), cliq2(clique[1]);
+    for (int i = 1; i <= clique[0]; i++) {
+      cliq1[i] = clique[1 + i];
+    }
+    for (int j = 1; j <= clique[1]; j++) {
+      cliq2[j] = clique[1 + clique[0] + j];
+    }
+    m_cliques1.Append(cliq1);
+    m_cliques2.Append(cliq2);
   }
 }
 
 // -------------------------------------------------- 
-int EnumCliques::getconnco(Gambit::Array<int> &firstedge,
-			   Gambit::Array<edge> &edgelist
-			   )
-  
-  /* reads edges of bipartite graph from input, puts them in disjoint
-     lists of edges representing its connected components 
-     pre:  nodes are nonzero integers < maxinp1,2
-     other edges are rejected, and so are edges starting
-     from the MAXEDGEth edge on and larger, each with a warning msg.
-     post: return value == numco  (largest index of a connected component)
-     where  numco < MAXCO,  and for   1 <= co <= numco:
-     edgelist[co].firstedge == 0    if  co  is not a component
-     == edgeindex  e  otherwise where  e > 0  and
-     edgelist[e].node1, .node2[e] are endpoints of edge,
-     edgelist[e].nextedge == next edgeindex of component,
-     zero if  e  is index to the last edge
+void EnumCliques::order(std::vector<int> &p_order) const
+  /* computes a degeneracy ordering of the nodes of the component,
+     and returns the right nodes in that order
   */
 {
-  int numco, newedge ;
-  Gambit::Array<int> co1(0,maxinp1-1), co2(0,maxinp2-1);   // components of node1,2  
-  int i, j;  // indices to left and right nodes 
-  
-  // initialize  component indices of left and right nodes 
-  for (i=0; i<maxinp1; i++)
-    co1[i] = 0;
-  for (j=0; j<maxinp2; j++)
-    co2[j] = 0;
-  
-  numco = 0;
-  for(newedge = 1;newedge<=edgelist.Length();newedge++) {
-    i = edgelist[newedge].node1;
-    j = edgelist[newedge].node2;
-    
-    if (i < 0 || i>= maxinp1 || j<0 || j>=maxinp2)
-      printf("Edge (%d, %d) not in admitted range (0..%d, 0..%d), rejected\n",
-	     i,j, maxinp1-1, maxinp2-1) ;
-    else { 
-      // add edge (i,j) to current componentlist 
-      int  ico, jco ;  // current components of i,j  
-      ico = co1[i] ;
-      jco = co2[j] ;
-      
-      if (ico == 0) {
-	//  i  has not yet been in a component before  
-	if (jco == 0) {
-	  //  j  has not yet been in a component before  
-	  //  add a new component  
-	  numco ++;
-	  co1[i] = co2[j] = numco ;
-	  firstedge[numco] = newedge ;
-	  edgelist[newedge].nextedge  = 0;
-	}
-	else { /* j  is already in a component: add  i  to j's
-		  component, adding list elements in front */
-	  co1[i] = jco ;
-	  edgelist[newedge].nextedge  = firstedge[jco];
-	  firstedge[jco] = newedge;
+  std::vector<int> degree1(m_m), degree2(m_n);
+  std::vector<bool> removed1(m_m, false), removed2(m_n, false);
+  // the remaining nodes by degree, with left nodes numbered from 0
+  // and right nodes from -1 downwards
+  std::set<std::pair<int, int> > queue;
+
+  for (int i = 0; i < m_m; i++) {
+    degree1[i] = m_adj1[i].size();
+    queue.insert(std::make_pair(degree1[i], i));
+  }
+  for (int j = 0; j < m_n; j++) {
+    degree2[j] = m_adj2[j].size();
+    queue.insert(std::make_pair(degree2[j], -j - 1));
+  }
+
+  p_order.clear();
+  while (!queue.empty()) {
+    int u = queue.begin()->second;
+    queue.erase(queue.begin());
+    if (u >= 0) {
+      removed1[u] = true;
+      for (unsigned int k = 0; k < m_adj1[u].size(); k++) {
+	int j = m_adj1[u][k];
+	if (!removed2[j]) {
+	  queue.erase(std::make_pair(degree2[j], -j - 1));
+	  queue.insert(std::make_pair(--degree2[j], -j - 1));
 	}
       }
-      else { // i  is already in a component 
-	if (jco == 0) {
-	  //  j  has not yet been in a component before  
-	  //  add  j  to  i's component  
-	  co2[j] = ico ;
-	  edgelist[newedge].nextedge  = firstedge[ico];
-	  firstedge[ico] = newedge;
-	}
-	else { // i  and  j  are already in components  
-	  if (ico == jco) {
-	    // i, j  in same component: just add the current edge 
-	    edgelist[newedge].nextedge  = firstedge[ico];
-	    firstedge[ico] = newedge;
-	  }
-	  else { /*  i  and  j  in different components:  
-		     merge these by traversing the edgelists
-		     and updating components of all incident nodes
-		     (this is wasteful since only nodes need be
-		     updated, not edges)  */
-	    int e, newco, oldco ;
-	    if (ico < jco) { newco = ico; oldco = jco; }
-	    else           { newco = jco; oldco = ico; }
-	    // insert the current edge 
-	    edgelist[newedge].nextedge= firstedge[oldco] ;
-	    e = newedge ; 
-	    while (1) {
-	      co1[edgelist[e].node1] = co2[edgelist[e].node2] = newco ;
-	      if (edgelist[e].nextedge == 0) break;
-	      e = edgelist[e].nextedge;
-	    }
-	    //  e  is now the last edge in the updated list  
-	    edgelist[e].nextedge = firstedge[newco] ;
-	    firstedge[newco] = newedge ;
-	    /* oldco is unused now: reuse it if it was the 
-	       last component, otherwise just leave empty */
-	    if (oldco == numco) numco-- ;
-	    firstedge[oldco] = 0;
-	  }
+    }
+    else {
+      int j = -u - 1;
+      removed2[j] = true;
+      p_order.push_back(j);
+      for (unsigned int k = 0; k < m_adj2[j].size(); k++) {
+	int i = m_adj2[j][k];
+	if (!removed1[i]) {
+	  queue.erase(std::make_pair(degree1[i], i));
+	  queue.insert(std::make_pair(--degree1[i], i));
 	}
       }
     }
-  }  // end scanning input 
-  return numco;
+  }
 }
 
+// -------------------------------------------------- 
+int EnumCliques::countconn(int p_node2, const NodeSet &p_set) const
+  // returns the number of nodes in  p_set  connected to right node p_node2
+{
+  const std::vector<int> &adj = m_adj2[p_node2];
+  if (!m_nbrs2.empty() && p_set.NumWords() < (int) adj.size()) {
+    return p_set.CountCommon(m_nbrs2[p_node2]);
+  }
+  int count = 0;
+  for (unsigned int i = 0; i < adj.size(); i++) {
+    if (p_set.Contains(adj[i]))  count++;
+  }
+  return count;
+}
 
 // -------------------------------------------------- 
-void EnumCliques::outCLIQUE(int clique1[], int cliqsize1, 
-			    int clique2[], int cliqsize2,
-			    int orignode1[MAXM],
-			    int orignode2[MAXN]
-			    ) 
-  // outputs  CLIQUE  using the original node numbers in  orignode
-  
+int EnumCliques::intersect(NodeSet &p_result, const NodeSet &p_set,
+			   int p_node2) const
+  /* sets  p_result  to the nodes in  p_set  connected to right node 
+     p_node2,  returning their number
+  */
 {
-  if (cliqsize1>0 && cliqsize2>0) {
-    int i;
-    //printf("{") ;
-    Array<int> cliq1;
-    for (i=0; i<cliqsize1; i++) {
-      cliq1.Append(orignode1[clique1[i]]);
-      //printf("%d", orignode1[clique1[i]]);
-      //if (i<cliqsize1-1) printf(", "); 
+  const std::vector<int> &adj = m_adj2[p_node2];
+  if (!m_nbrs2.empty() && p_set.NumWords() < (int) adj.size()) {
+    return p_result.Intersect(p_set, m_nbrs2[p_node2]);
+  }
+  int count = 0;
+  p_result.Clear(m_m);
+  for (unsigned int i = 0; i < adj.size(); i++) {
+    if (p_set.Contains(adj[i])) {
+      p_result.Insert(adj[i]);
+      count++;
     }
-    m_cliques1.Append(cliq1);
-
-    //printf("}  x  {") ;
-    //  the  "x"  in the output symbolizes the product set 
+  }
+  return count;
+}
 
-    Array<int> cliq2;
-    for (i=0; i<cliqsize2; i++) {
-      cliq2.Append(orignode2[clique2[i]]);
-      //printf("%d", orignode2[clique2[i]]);
-      //if (i<cliqsize2-1) printf(", "); 
-    }
-    m_cliques2.Append(cliq2);
-    //    printf("}\n");
+// -------------------------------------------------- 
+bool EnumCliques::covered(const NodeSet &p_set1)
+  /* returns whether some right node all of whose maximal cliques have
+     been generated is connected to every node of  p_set1;
+     pre:  the bitsets of neighbours are stored
+  */
+{
+  m_work = m_tried;
+  for (int i = p_set1.Next(0); i >= 0; i = p_set1.Next(i + 1)) {
+    if (m_work.Intersect(m_work, m_nbrs1[i]) == 0)  return false;
   }
+  return true;
 }
 
 // -------------------------------------------------- 
-void EnumCliques::workonco(int numco,
-			   Gambit::Array<int> &firstedge,
-			   Gambit::Array<edge> &edgelist
-			   )
-  /* works on the edgelists as generated by  getconnco
-     it processes each component by computing its maximal cliques 
-     pre : firstedge[1..numco], if nonzero, points to a connected component
-     in edgelist
-     post: all components are processed
+void EnumCliques::extend(int p_depth, 
+			 const std::vector<int> &p_cand,
+			 const std::vector<int> &p_not,
+			 int p_tried)
+  /* completes the extension of CLIQUE by a candidate, and outputs it
+     and its extensions if it is maximal.
+
+     pre:  V = m_clique2,  and  U  is in  m_levels[p_depth];
+     p_cand  and  p_not  are CAND and NOT before the extension, 
+     and  p_tried  is the candidate which was added, or -1 if none;
+     all cliques extending  V  containing a node in  p_not  
+     have already been generated
+     post: output of all maximal cliques extending  V  with
+     candidates from  p_cand  but not from p_not;
+     m_clique2  unchanged
   */
 {
-  int orignode1[MAXM];
-  int orignode2[MAXN];
-  bool connected[MAXM][MAXN];
-  int m; int n;   // graph dimensions 
-  
-  int stk[STKSIZE];  // stack 
-  int tos;  // top of stack 
-  int clique1[MAXM], clique2[MAXN];
-  // CLIQUE for first and second node class  
-  
-  int co;
-  int countco = 0;
-  
-  for (co=1; co <= numco; co++) 
-    if (firstedge[co]) {
-      // found a nonzero component list 
-      countco ++ ;
-      //printf("\nConnected component %d:\n", countco) ;
-      
-      genincidence(firstedge[co], edgelist,
-		   orignode1, orignode2, connected, &m, &n);
-      
-      /* compute the cliques of the component via  extend;
-	 initialize stack with the full sets of nodes
-	 and empty sets CAND and NOT  */
-      tos = 0;
-      {
-	int i ;
-	for (i=0; i<m; i++)  stk[tos++] = i;   // CAND1 = NODES1 
-	for (i=0; i<n; i++)  stk[tos++] = i;   // CAND2 = NODES2 
+  CliqueLevel &level = m_levels[p_depth];
+  level.cand.clear();
+  level.candconn.clear();
+  level.notset.clear();
+  level.notconn.clear();
+
+  /* with the bitsets of neighbours, NOT is checked by  covered()
+     before the extension, and is not kept as a list */
+  for (unsigned int k = 0; k < p_not.size(); k++) {
+    if (p_depth > 0 && m_levels[p_depth - 1].notconn[k] < level.cliqsize1) {
+      /* the node cannot be connected to all of  U,  and the number of
+	 its connections at the previous depth is kept as a bound */
+      level.notset.push_back(p_not[k]);
+      level.notconn.push_back(m_levels[p_depth - 1].notconn[k]);
+      continue;
+    }
+    int conn = countconn(p_not[k], level.clique1);
+    if (conn == level.cliqsize1) {
+      // all cliques extending  V  have already been generated
+      return;
+    }
+    else if (conn > 0) {
+      level.notset.push_back(p_not[k]);
+      level.notconn.push_back(conn);
+    }
+  }
+
+  /* a candidate connected to all of the new U, and to no more of 
+     the previous U, would give the same clique again if it were tried
+     in turn, so it is dropped from the previous CAND */
+  int cliqsize2 = m_clique2.size();
+  for (unsigned int k = 0; k < p_cand.size(); k++) {
+    if (p_cand[k] == p_tried)  continue;
+    int conn = countconn(p_cand[k], level.clique1);
+    if (conn == level.cliqsize1) {
+      m_clique2.push_back(p_cand[k]);
+      if (p_depth > 0 && 
+	  m_levels[p_depth - 1].candconn[k] == level.cliqsize1) {
+	m_levels[p_depth - 1].dropped.push_back(p_cand[k]);
       }
-      extend(stk, connected, clique1, 0, clique2, 0,
-	     0, 0, m, m, m, m+n, tos, orignode1, orignode2);
     }
-}
+    else if (conn > 0) {
+      level.cand.push_back(p_cand[k]);
+      level.candconn.push_back(conn);
+    }
+  }
 
+  outCLIQUE(p_depth);
+  search(p_depth);
+  m_clique2.resize(cliqsize2);
+}
 
-// ----- the following are unused TEST ROUTINES ----- 
 // -------------------------------------------------- 
-void EnumCliques::getgraph(bool connected[MAXM][MAXN], int *m, int *n)
-  /* pre:  graph edges as pairs of nonnegative integers on standard input
-     edges with nodes <0 or >=MAXM/2  will be rejected
-     with a warning message
-     post: connected[i][j] = true for the edges (i,j) of the bipartite
-     graph, nodes numbered  0..*m-1  and  0..*n-1
-     m <= MAXM,  n <= MAXN
+void EnumCliques::search(int p_depth)
+  /* tries each candidate which is not passed over by pivoting,
+     moving it from CAND to NOT afterwards
+     pre:  CLIQUE is maximal, with CAND and NOT in  m_levels[p_depth]
   */
-{ 
-  int i, j;
-  for (i=0; i<MAXM; i++)
-    for (j=0; j<MAXN; j++)
-      connected[i][j] = false;
-  *m = *n = 0;
-  while (scanf("%d %d", &i, &j) != EOF) {
-    if (i < 0 || i>= MAXM || j<0 || j>=MAXN)
-      printf("Edge (%d, %d) not in admitted range (0..%d, 0..%d), rejected\n",
-	     i,j, MAXM-1, MAXN-1) ;
+{
+  CliqueLevel &level = m_levels[p_depth];
+  if (level.cand.empty())  return;
+
+  /* find pivot  p  in NOT or CAND  with the largest
+     number of connections to U */
+  int pivot = -1, maxconn = -1;
+  for (unsigned int k = 0; k < level.cand.size(); k++) {
+    if (level.candconn[k] > maxconn) {
+      pivot = level.cand[k];
+      maxconn = level.candconn[k];
+    }
+  }
+  for (unsigned int k = 0; k < level.notset.size(); k++) {
+    if (level.notconn[k] > maxconn) {
+      pivot = level.notset[k];
+      maxconn = level.notconn[k];
+    }
+  }
+  intersect(level.pivot1, level.clique1, pivot);
+
+  /* try  p  and the candidates connected to a node of  U  which  p  is
+     not, those with fewest connections to  U  first, as their cliques
+     are the least likely to be contained in those found later */
+  std::vector<std::pair<int, int> > tries;
+  for (unsigned int k = 0; k < level.cand.size(); k++) {
+    int c = level.cand[k];
+    if (c == pivot || countconn(c, level.pivot1) < level.candconn[k]) {
+      tries.push_back(std::make_pair(level.candconn[k], c));
+    }
+  }
+  std::sort(tries.begin(), tries.end());
+  level.tries.clear();
+  for (unsigned int t = 0; t < tries.size(); t++) {
+    level.tries.push_back(tries[t].second);
+  }
+
+  // the sets for the next depth are added as needed, and reused
+  if ((int) m_levels.size() < p_depth + 2) {
+    m_levels.resize(p_depth + 2);
+  }
+  CliqueLevel &next = m_levels[p_depth + 1];
+  level.dropped.clear();
+  for (unsigned int t = 0; t < level.tries.size(); t++) {
+    int c = level.tries[t];
+    next.cliqsize1 = intersect(next.clique1, level.clique1, c);
+    if (m_nbrs1.empty() || !covered(next.clique1)) {
+      m_clique2.push_back(c);
+      extend(p_depth + 1, level.cand, level.notset, c);
+      m_clique2.pop_back();
+    }
+
+    int k = std::find(level.cand.begin(), level.cand.end(), c) - 
+      level.cand.begin();
+    if (!m_nbrs1.empty()) {
+      m_tried.Insert(c);
+    }
     else {
-      connected[i][j] = true ;
-      *m = MAX(*m, i+1) ;
-      *n = MAX(*n, j+1) ;
+      level.notset.push_back(c);
+      level.notconn.push_back(level.candconn[k]);
+    }
+    level.cand.erase(level.cand.begin() + k);
+    level.candconn.erase(level.candconn.begin() + k);
+
+    // every maximal clique containing a dropped candidate contains c
+    for (unsigned int d = 0; d < level.dropped.size(); d++) {
+      int k = std::find(level.cand.begin(), level.cand.end(), 
+			level.dropped[d]) - level.cand.begin();
+      level.cand.erase(level.cand.begin() + k);
+      level.candconn.erase(level.candconn.begin() + k);
+      std::vector<int>::iterator pos = std::find(level.tries.begin() + t + 1,
+						 level.tries.end(),
+						 level.dropped[d]);
+      if (pos != level.tries.end())  level.tries.erase(pos);
+    }
+    level.dropped.clear();
+  }
+
+  if (!m_nbrs1.empty()) {
+    for (unsigned int t = 0; t < level.tries.size(); t++) {
+      m_tried.Remove(level.tries[t]);
     }
   }
 }
+
 // -------------------------------------------------- 
-void EnumCliques::outgraph(
-			   int orignode1[MAXM],
-			   int orignode2[MAXN],
-			   bool connected[MAXM][MAXN],
-			   int m,
-			   int n
-			   )
-  /* prints the graph incidence matrix on standard output
-     including information about original node numbers */
+void EnumCliques::outCLIQUE(int p_depth)
+  // records  CLIQUE  using the original node numbers
 {
-  int i, j;
-  printf("\nConnected component: ") ;
-  printf("%d columns of right hand side nodes are\n       ", n) ;
-  for (j=0; j<n; j++)
-    printf("%d ", orignode2[j]);
-  printf("\nincidence matrix with %d rows:\n", m) ;
-  for (i=0; i<m; i++){
-    printf("%5d:", orignode1[i]);
-    for (j=0; j<n; j++)
-      printf("%2d",  connected[i][j]);
-    printf("\n");
+  const CliqueLevel &level = m_levels[p_depth];
+  int start = m_found.size();
+  m_starts.push_back(start);
+  m_found.push_back(level.cliqsize1);
+  m_found.push_back(m_clique2.size());
+  for (int i = level.clique1.Next(0); i >= 0; i = level.clique1.Next(i + 1)) {
+    m_found.push_back(m_orignode1[i]);
   }
+  for (unsigned int j = 0; j < m_clique2.size(); j++) {
+    m_found.push_back(m_orignode2[m_clique2[j]]);
+  }
+  // the left nodes are in increasing order already
+  std::sort(m_found.begin() + start + 2 + level.cliqsize1, m_found.end());
 }
-
-
-
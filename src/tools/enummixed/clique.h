@@ -3,7 +3,7 @@
 // Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
 //
 // FILE: src/tools/enummixed/clique.h
-// Maximal cliques and connected components via von Stengel's algorithm
+// Maximal cliques and connected components of bipartite graphs
 //
 // This program is free software; you can redistribute it and/or modify
 // it under the terms of the GNU General Public License as published by
@@ -42,167 +42,90 @@
 //      (so these are the maximal complete bipartite subgraphs or CLIQUES).
 //
 //    INPUT:
-//    The edges (i, j) are given by pairs of nonnegative integers separated
-//    by blanks on standard input.
+//    The edges (i, j) as an array of pairs of nonnegative integers.
 //
 //    OUTPUT:
-//    On standard output,
-//    a headline for each connected component, then
-//    the cliques  U x V  listing  U  and  V  separately as lists
-//    of integers, separated by  "x"  and each set enclosed in braces, 
-//    one clique per line.
+//    The cliques  U x V,  listing  U  and  V  separately, by component
+//    in the order of the first edge of each in the input, and within
+//    each component in increasing lexicographic order of U, then V.
+//    Each set is listed in increasing order.
 //
 //    METHOD:
-//    Connected components by a primitive version of union-find,
+//    Connected components by union-find,
 //    cliques with a variant of the algorithm by
 //    [BK] C. Bron and J. Kerbosch, Finding all cliques of an undirected
 //         graph, Comm. ACM 16:9 (1973), 575-577.
 //
-//    APPROXIMATE STORAGE REQUIREMENTS:
-//    for integer arrays, 4 bytes per integer, using constants
-//    maxinp1, maxinp2  max. node indices in input
-//    MAXEDGES          max. no. edges in input
-//    MAXM, MAXN        max. dimension of incidence matrix
-//   	              per connected component
-//    2 x MAXM x MAXN  integers for incidence matrix and stack
-//	   [2 MB  if MAXM = MAXN = 700 ]
-//    3 x MAXEDGES  integers for edge list
-//	   [0.6 MB  if  MAXEDGES = 50000 ]
-//    3 x maxinp1  integers for input nodes and list of components
-//	   [60 kB   if  maxinp1 = maxinp2 = 5000 ]
-//    If these constants are exceeded certain edges will be rejected
-//    from the input with an error message.  Program shouldn't crash.
-//    No error value is returned by  main().
-//
 //    DETAILS OF METHODS:
 //
 //    a) Connected components
 //
-//    Designed for minimum storage requirement, running time
-//    possibly quadratic in number of edges.
-//    For each node that is read, a component  co1[i]  resp.  co2[j]
-//    ( i  left node,  j  right node) is kept, initially  0  if node
-//    is not yet input.  (Isolated nodes are treated as absent.)
-//    For an edge  (i, j),  i and j  must be put in the same component.
-//    Each component  co  points to the first edge in  edgelist,
-//    where the edges are linked.  Merging two components is done
-//    by traversing the edgelist with the higher number, updating
-//    the component number of the nodes therein, and prepending
-//    it to the list of the other component.
-//    Components and edges are numbered starting with 1,  so "no
-//    component" and the end of an edgelist is represented by 0.
-//
-//    Sets are represented by C arrays, if starting with 0
-//    (as usually in C),  then the elements of a  k-set are the
-//    array elements [0..k) i.e. [0..k-1],  if starting with 1
-//    they are [1..k].
+//    The nodes are merged into components by union-find as the edges
+//    are read, and the edges are then listed by component.
 //
-//    A possible improvement is to keep extra lists of the
-//    equivalence classes for the nodes for each component so only
-//    these have to be updated, which makes it faster.  
-//    
 //    b) Clique enumeration
 //
-//    The procedure  extend  recursively extends a current set of pairs
-//    clique1, clique2  that eventually will form a maximal clique.
-//    In [BK], this is only a single set  COMPSUB (here called CLIQUE),
-//    here two sets are used since the graph is bipartite.  
-//    Cliques of a bipartite graph are equivalent to the cliques of
-//    the ordinary graph obtained by connecting all left nodes by
-//    themselves and all right nodes by themselves, except for
-//    the cliques consisting exclusively of left or right points.
-//
-//    The recursive calls use a self-made stack  stk  containing
-//    local small arrays of variable size.  Intervals of this stack
-//    are indicated by their endpoints which ARE local variables
-//    to the recursive call.  The top of the stack  tos  is passed
-//    as a parameter.
-//
-//    The extension is done by adding points from a set CAND of 
-//    candidates to CLIQUE.  Throughout, the points in CAND are
-//    connected to all points in  CLIQUE,  which holds at initialization
-//    when CAND contains all points and CLIQUE is empty.  
-//
-//    Traversing the backtracking tree:  Extending its depth is
-//    done by picking  c  (cand  in the code below) from CAND,
-//    adding  c  to CLIQUE, removing all points not connected to  c 
-//    from CAND, and handing the new sets CLIQUE and CAND
-//    to the recursive call.
-//    For extending the backtracking tree in its breadth, this is
-//    done in a loop (called backtracking cycle in [BK]) where repeatedly
-//    different candidates  c  are added to CLIQUE (after the respective
-//    return from the recursive call).  In order to avoid the output
-//    of cliques that are not maximal, an additional set NOT is passed
-//    down as a parameter to the recursive call of  extend.
-//    This set NOT contains candidates  c  that 
-//    - are all connected to the elements in CLIQUE but
-//    - have already been tried out, that is, all extensions of CLIQUE
-//      containing any point in NOT have already been generated [BK, p.577].  
-//
-//    Hence, the recursive call proceeds downwards by
-//    - removing  c  from CAND and adding it to CLIQUE
-//    - removing all points disconnected from  c  from the new
-//      sets  NOT  and  CAND  used in the recursive call.
-//    After extension,  c  is then moved to  NOT  and the next
-//    candidate is tried.
-//
-//    To reduce the breadth of the backtracking tree, the first
-//    candidate (or the subsequent ones) are chosen such that
-//    as early as possible there is a node in NOT connected to all
-//    remaining candidates.  Then NOT will never become empty and
-//    hence no clique will be output, so the backtracking tree can
-//    be pruned here.  This is done by choosing first a  fixpoint  fixp
-//    in the set  NOT  or  CAND, such that after extension, when
-//    fixp  is definitely in  NOT,  only points disconnected to  fixp
-//    are added.  Their number is the smallest possible.
-//
-//    This is version2 of the algorithm in [BK]:
-//    a - pick  fixp  in NOT or CAND  with the smallest number of 
-//        disconnections to the other nodes in CAND,
-//    b - if  fixp  is a candidate, try it out as a candidate, i.e.
-//        extend  CLIQUE  with  fixp  (procedures  candtry  below),
-//	and then move   fixp  to  NOT after extension.
-//    c - then try out only points disconnected to  fixp,  as
-//	determined in a.  (In contrast to [BK], we compute
-//	a local list of these disconnected points while looking
-//	for the smallest number of disconnections.)
-//
-//    Amendments for the bipartite graph are here:  a  is done
-//    by inspecting both sides of the graph.
-//    For the single extension in  b  (if  fixp  is a candidate)
-//    and the extensions in  c , only the sets NOT and CAND
-//    on the other side of the candidate used for extension
-//    have to be updated.  Hence,  NOT and CAND are kept as
-//    separate sets  NOT1,  NOT2  and CAND1, CAND2.
+//    As in [BK], a current clique is extended by candidates from a set
+//    CAND, while a set NOT holds the nodes which have already been 
+//    tried, so that all cliques containing them have been generated.
+//    Since the graph is bipartite, the candidates are only the right
+//    nodes:  CLIQUE  is a set  V  of right nodes together with the set
+//    U  of all left nodes connected to every node of  V,  kept as a
+//    bitset.  Adding a candidate  c  to  V  replaces  U  by the nodes 
+//    of  U  connected to  c.  Then
+//    - if a node of NOT is connected to all of the new  U,  every
+//      clique extending  V  has already been generated, and the branch
+//      is cut;
+//    - each candidate connected to all of the new  U  is added to  V
+//      at once, as it is in every maximal clique extending  V,  and the
+//      nodes of CAND and NOT connected to none of  U  are dropped;
+//    - the resulting  U x V  is maximal, and is output.
+//    A candidate connected to all of the new  U  and to no other node 
+//    of the previous  U  would lead to the same cliques as  c,  so it
+//    is not tried after  c  at the previous level.  The candidates are
+//    tried in increasing order of their number of connections to  U.
+//
+//    If the component is small enough, the neighbours of each node are
+//    also kept as bitsets, so that the counts are taken a word at a
+//    time.  NOT is then kept only as a single bitset of right nodes,
+//    and a candidate is checked against it, by intersecting it with
+//    the neighbours of each node of the new  U,  before it is added.
+//
+//    To reduce the breadth of the backtracking tree, a pivot  p  in
+//    CAND or NOT (only CAND if NOT is kept as a bitset) connected to
+//    as many nodes of  U  as possible is chosen, and only  p  and the candidates  c  connected to some node
+//    of  U  not connected to  p  are tried.  Every maximal clique
+//    containing any other candidate also contains  p,  so is found
+//    when  p  is tried, or has been found already if  p  is in NOT.
+//    This is the pivoting rule of
+//    [TTT] E. Tomita, A. Tanaka, H. Takahashi, The worst-case time
+//         complexity for generating all maximal cliques and
+//         computational experiments, Theor. Comp. Sci. 363 (2006) 28-42.
+//
+//    At the top level, the right nodes are tried in a degeneracy
+//    ordering of the graph, that is, repeatedly taking a node with
+//    fewest neighbours among those not yet taken, as in
+//    [ELS] D. Eppstein, M. Loeffler, D. Strash, Listing all maximal
+//         cliques in sparse graphs in near-optimal time, ISAAC 2010.
+//    For each node, CAND and NOT are the nodes later, respectively 
+//    earlier, in the order which share a neighbour with it, so that 
+//    the work for each node depends only on its neighbourhood, and
+//    not on the size of its component.
 
 #ifndef CLIQUE_H
 #define CLIQUE_H
 
 #include <cstdio>
+#include <vector>
+#include <deque>
 #include "libgambit/libgambit.h"
 
 using namespace Gambit;
 
-#define MAX(A,B)  ((A) > (B) ? (A) : (B))
-#define MIN(A,B)  ((A) < (B) ? (A) : (B))
-
-#define MAXM 700     // max. no of left nodes for incidence matrix 
-#define MAXN MAXM  // max. no of right nodes for incidence matrix 
-
-#define MAXINP1 5000        // max. no of left nodes in input 
-#define MAXINP2 MAXINP1  // max. no of right nodes in input 
-#define MAXEDGES   50000       // max. no of edges in input 
-#define MAXCO  MIN(MAXINP1, MAXINP2) + 1
-  // max. no of connected components;  on the smaller side,
-  // each node could be in different component 
-#define STKSIZE  (MAXM + 1) * (MAXN + 1)  
-  // largest stack usage for full graph 
-
 class edge {
 public:
   int node1;
   int node2;
-  int nextedge;
   edge() { };
   ~edge() { } ;
   // gArray requires the following operators to exist
@@ -212,87 +135,96 @@ public:
     {return !(*this == y);}
 };
 
+//
+// A set of the nodes on one side of a component, numbered from zero,
+// as a bitset
+//
+class NodeSet {
+private:
+  std::vector<unsigned long> m_bits;
+
+  static const int s_wordBits = 8 * sizeof(unsigned long);
+
+public:
+  NodeSet(int p_size = 0)
+    : m_bits((p_size + s_wordBits - 1) / s_wordBits, 0UL) { }
+
+  // empties the set, and sets the number of nodes it may hold
+  void Clear(int p_size)
+    { m_bits.assign((p_size + s_wordBits - 1) / s_wordBits, 0UL); }
+
+  bool Contains(int p_node) const
+    { return (m_bits[p_node / s_wordBits] >> (p_node % s_wordBits)) & 1UL; }
+  void Insert(int p_node)
+    { m_bits[p_node / s_wordBits] |= 1UL << (p_node % s_wordBits); }
+  void Remove(int p_node)
+    { m_bits[p_node / s_wordBits] &= ~(1UL << (p_node % s_wordBits)); }
+
+  // the first node in the set not less than p_node, or -1 if none
+  int Next(int p_node) const;
+  // the number of nodes in both this set and p_set
+  int CountCommon(const NodeSet &p_set) const;
+  // makes this the intersection of p_set1 and p_set2, returning its size
+  int Intersect(const NodeSet &p_set1, const NodeSet &p_set2);
+  // the number of words in the bitset
+  int NumWords(void) const { return m_bits.size(); }
+};
+
+//
+// The sets used at one depth of the backtracking: the left nodes U
+// of CLIQUE, and CAND and NOT, with the number of nodes of U connected 
+// to each of their nodes (for NOT, this may be an upper bound)
+//
+class CliqueLevel {
+public:
+  NodeSet clique1, pivot1;
+  int cliqsize1;
+  std::vector<int> cand, candconn, notset, notconn, tries;
+  // candidates found to be equivalent to the one being tried
+  std::vector<int> dropped;
+};
+
 class EnumCliques {
 private:
-  Array<int> firstedge;
-  int maxinp1,maxinp2;
   List<Array<int> > m_cliques1, m_cliques2;
 
-  void candtry1 (int stk[], // stack 
-	 bool connected[MAXM][MAXN],
-	 int cand,  // the candidate from NODES1  to be added to CLIQUE	 
-	 int clique1[], int cliqsize1,  // CLIQUE so far in NODES1 
-	 int clique2[], int cliqsize2,  // CLIQUE so far in NODES2 
-	 int sn1, int *sc1, int ec1,   // start NOT1, start CAND1, end CAND1 
-	 int sn2, int sc2, int ec2,   // start NOT2, start CAND2, end CAND2 
-	 int tos,  // top of stack 
-	 int orignode1[MAXM],
-	 int orignode2[MAXN]
-         );
-  void candtry2 (int stk[], // stack 
-	 bool connected[MAXM][MAXN],
-	 int cand,  // the candidate from NODES2  to be added to CLIQUE 
-	 int clique1[], int cliqsize1,  // CLIQUE so far in NODES1 
-	 int clique2[], int cliqsize2,  // CLIQUE so far in NODES2 
-	 int sn1, int sc1, int ec1,   // start NOT1, start CAND1, end CAND1 
-	 int sn2, int *sc2, int ec2,   // start NOT2, start CAND2, end CAND2 
-	 int tos,  // top of stack 
-	 int orignode1[MAXM],
-	 int orignode2[MAXN]);
-  void extend (int stk[], // stack 
-       bool connected[MAXM][MAXN],
-       int clique1[], int cliqsize1,  // CLIQUE so far in NODES1 
-       int clique2[], int cliqsize2,  // CLIQUE so far in NODES2 
-       int sn1, int sc1, int ec1,   // start NOT1, start CAND1, end CAND1 
-       int sn2, int sc2, int ec2,   // start NOT2, start CAND2, end CAND2 
-       int tos,   // top of stack,   tos >= ec1, ec2  
-       int orignode1[MAXM],   // original node numbers as input 
-       int orignode2[MAXN]);
-  void findfixpoint(int stk[], // stack 
-	    bool connected[MAXM][MAXN],
-	    int *savelist,      // position of savelist on the stack 
-	    int *tmplist,       // position of tmplist on the stack 
-	    int *minnod,        // currently lowest no. of disconnections 
-	    int sninspect, int ecinspect,
-	    int scother, int ecother,
-	    bool binspect1,  // inspected nodes are in class1, o/w class2 
-	    bool *bfound,  // a new lower no. of disconnections was found 
-	    int *fixp,     // the new fixpoint, if *bfound = true  
-	    int *posfix);    // position of fixpoint on the stack, if *bfound 
+  // The component being worked on: m left nodes and n right nodes,
+  // each numbered from zero, with their original numbers, and the
+  // neighbours of each
+  int m_m, m_n;
+  std::vector<int> m_orignode1, m_orignode2;
+  std::vector<std::vector<int> > m_adj1, m_adj2;
+  // the neighbours of each node as bitsets, if the component is
+  // small enough to store them, with the right nodes all of whose
+  // cliques have been generated, and a set used in checking them
+  std::vector<NodeSet> m_nbrs1, m_nbrs2;
+  NodeSet m_tried, m_work;
+
+  // the right nodes V of CLIQUE, and the sets at each depth
+  std::vector<int> m_clique2;
+  std::deque<CliqueLevel> m_levels;
+
+  // the cliques found in the component, each stored in m_found as
+  // the sizes of its two sides followed by their nodes, from m_starts[c]
+  std::vector<int> m_found, m_starts;
+
+  void workonco(const std::vector<int> &p_edges, const Array<edge> &p_edgelist);
+  void order(std::vector<int> &p_order) const;
+  int countconn(int p_node2, const NodeSet &p_set) const;
+  int intersect(NodeSet &p_result, const NodeSet &p_set, int p_node2) const;
+  bool covered(const NodeSet &p_set1);
+  void extend(int p_depth, const std::vector<int> &p_cand,
+	      const std::vector<int> &p_not, int p_tried);
+  void search(int p_depth);
+  void outCLIQUE(int p_depth);
+
 public:
-  EnumCliques(Array<edge> &, int, int);
+  EnumCliques(const Array<edge> &, int, int);
   ~EnumCliques();
 
   const List<Array<int> > &GetCliques1(void) const { return m_cliques1; }
   const List<Array<int> > &GetCliques2(void) const { return m_cliques2; }
-
-  void genincidence(int e,
-		    Array<edge> &edgelist,
-		    int orignode1[MAXM],
-		    int orignode2[MAXN],
-		    bool connected[MAXM][MAXN],
-		    int *m,
-		    int *n);
-  int getconnco(Array<int> &firstedge,
-		Array<edge> &edgelist);
-  void outCLIQUE(int clique1[], int cliqsize1, 
-		 int clique2[], int cliqsize2,
-		 int orignode1[MAXM],
-		 int orignode2[MAXN]);
-  void workonco(int numco,
-		Array<int> &firstedge,
-		Array<edge> &edgelist);
-
-/* --- the following are unused TEST ROUTINES --- */
-  void getgraph(bool connected[MAXM][MAXN], int *m, int *n);
-  void outgraph(int orignode1[MAXM],
-		int orignode2[MAXN],
-		bool connected[MAXM][MAXN],
-		int m,
-		int n);
 };
 
 
 #endif // CLIQUE_H
-
-
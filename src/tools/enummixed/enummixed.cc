@@ -27,16 +27,21 @@
 #include <fstream>
 #include <cerrno>
 #include <iomanip>
+#include <vector>
 
 #include "libgambit/libgambit.h"
+#include "libgambit/threads.h"
 #include "clique.h"
 #include "vertenum.imp"
+#include "lrsnash.h"
 
 
 using namespace Gambit;
 
 bool g_showConnect = false;
 int g_numDecimals = 6;
+bool g_hybrid = false;
+int g_numThreads = 1;
 
 bool EqZero(const double &x)
 {
@@ -136,6 +141,176 @@ template <class T> void GetCliques(std::ostream &p_stream,
   }
 }
 
+//
+// In hybrid mode, the vertices of the polyhedron are enumerated in
+// floating point, and each is then recomputed exactly from its basis.
+// The exact tableau is moved from each vertex to the next, which is
+// usually only a few pivots away.  Vertices whose basis is singular or
+// infeasible in exact arithmetic are artifacts of rounding, and are
+// dropped.
+//
+template <class T> 
+List<BFS<T> > HybridVertices(const Matrix<T> &A, const Vector<T> &b)
+{
+  Matrix<double> fA(A.MinRow(), A.MaxRow(), A.MinCol(), A.MaxCol());
+  for (int i = A.MinRow(); i <= A.MaxRow(); i++) {
+    for (int j = A.MinCol(); j <= A.MaxCol(); j++) {
+      fA(i, j) = (double) A(i, j);
+    }
+  }
+  Vector<double> fb(b.First(), b.Last());
+  for (int i = b.First(); i <= b.Last(); i++) {
+    fb[i] = (double) b[i];
+  }
+  VertEnum<double> poly(fA, fb, g_numThreads);
+  const List<BFS<double> > &fverts(poly.VertexList());
+
+  Tableau<T> tab(A, b);
+  List<BFS<T> > verts;
+  for (int v = 1; v <= fverts.Length(); v++) {
+    BFS<double> fbfs(fverts[v]);
+    Array<int> labels;
+    for (int i = -A.MaxRow(); i <= A.MaxCol(); i++) {
+      if (fbfs.count(i))  labels.Append(i);
+    }
+
+    try {
+      PivotToBasis(tab, labels);
+    }
+    catch (Exception &) {
+      // the basis is singular in exact arithmetic
+      continue;
+    }
+
+    BFS<T> bfs(tab.GetBFS1());
+    bool feasible = true;
+    for (int i = -A.MaxRow(); feasible && i <= A.MaxCol(); i++) {
+      // as b <= 0, the basic variables are nonpositive
+      feasible = (bfs[i] <= (T) 0);
+    }
+    if (feasible) {
+      verts.Append(bfs);
+    }
+  }
+  return verts;
+}
+
+//
+// Enumerates the vertices of A x + b <= 0, x >= 0, in floating point
+// and checked exactly if in hybrid mode.  The reverse search of each
+// polytope is shared out among the threads.
+//
+template <class T>
+List<BFS<T> > Vertices(const Matrix<T> &A, const Vector<T> &b)
+{
+  if (g_hybrid) {
+    return HybridVertices(A, b);
+  }
+  else {
+    VertEnum<T> poly(A, b, g_numThreads);
+    return poly.VertexList();
+  }
+}
+
+//
+// A set of labels, stored as a bitset.  Label k is the k-th strategy
+// of player 1, and label n1 + k the k-th strategy of player 2.  A
+// vertex carries the label of each strategy which its player does not
+// use, or which is not a best reply to it; a pair of vertices is an
+// equilibrium exactly when every label is carried by one of them.
+//
+class LabelSet {
+private:
+  std::vector<unsigned long> m_bits;
+
+  static const int s_wordBits = 8 * sizeof(unsigned long);
+
+public:
+  LabelSet(int p_numLabels = 0)
+    : m_bits((p_numLabels + s_wordBits - 1) / s_wordBits, 0UL) { }
+
+  void Insert(int p_label)
+  { m_bits[(p_label - 1) / s_wordBits] |= 1UL << ((p_label - 1) % s_wordBits); }
+
+  // true if each label in p_all is in this set or in p_other
+  bool Complements(const LabelSet &p_other, const LabelSet &p_all) const
+  {
+    for (unsigned int w = 0; w < m_bits.size(); w++) {
+      if ((m_bits[w] | p_other.m_bits[w]) != p_all.m_bits[w])  return false;
+    }
+    return true;
+  }
+};
+
+//
+// Returns the labels of a vertex, with p_ownLabels strategies of its
+// own player numbered after p_ownOffset, and p_otherLabels of the
+// opponent (the slacks) numbered after p_otherOffset.
+//
+template <class T> LabelSet VertexLabels(BFS<T> p_bfs, int p_numLabels,
+					 int p_ownLabels, int p_ownOffset,
+					 int p_otherLabels, int p_otherOffset)
+{
+  LabelSet labels(p_numLabels);
+  for (int k = 1; k <= p_ownLabels; k++) {
+    if (!p_bfs.count(k) || EqZero(p_bfs[k])) {
+      labels.Insert(p_ownOffset + k);
+    }
+  }
+  for (int k = 1; k <= p_otherLabels; k++) {
+    if (!p_bfs.count(-k) || EqZero(p_bfs[-k])) {
+      labels.Insert(p_otherOffset + k);
+    }
+  }
+  return labels;
+}
+
+//
+// Checks pairs of vertices for complementarity.  The vertices of the
+// second polytope are handed out one at a time to whichever thread is
+// free, and each is paired with all vertices of the first; the matches
+// are recorded by vertex, so they can be output in the same order
+// however many threads are used.
+//
+class VertexPairTask : public ThreadTask {
+private:
+  const Array<LabelSet> &m_labels1, &m_labels2;
+  const LabelSet &m_all;
+  Array<List<int> > &m_matches;
+  Mutex m_mutex;       // protects m_next
+  int m_next;
+
+public:
+  VertexPairTask(const Array<LabelSet> &p_labels1,
+		 const Array<LabelSet> &p_labels2,
+		 const LabelSet &p_all, Array<List<int> > &p_matches)
+    : m_labels1(p_labels1), m_labels2(p_labels2), m_all(p_all),
+      m_matches(p_matches), m_next(2) { }
+  virtual ~VertexPairTask() { }
+
+  void Run(void);
+};
+
+void VertexPairTask::Run(void)
+{
+  while (true) {
+    int i2;
+    {
+      MutexLock lock(m_mutex);
+      i2 = m_next++;
+    }
+    if (i2 > m_labels2.Length())  return;
+
+    // the first vertex of each polytope is the origin, which is skipped
+    const LabelSet &labels2 = m_labels2[i2];
+    for (int i1 = 2; i1 <= m_labels1.Length(); i1++) {
+      if (labels2.Complements(m_labels1[i1], m_all)) {
+	m_matches[i2].Append(i1);
+      }
+    }
+  }
+}
+
 template <class T> void Solve(const StrategySupport &p_support)
 {
   List<Vector<T> > key1, key2;  
@@ -178,14 +353,36 @@ template <class T> void Solve(const StrategySupport &p_support)
   b2 = (T) -1;
 
   // enumerate vertices of A1 x + b1 <= 0 and A2 x + b2 <= 0
-  VertEnum<T> poly1(A1, b1);
-  VertEnum<T> poly2(A2, b2);
-
-  const List<BFS<T> > &verts1(poly1.VertexList());
-  const List<BFS<T> > &verts2(poly2.VertexList());
+  List<BFS<T> > verts1(Vertices(A1, b1));
+  List<BFS<T> > verts2(Vertices(A2, b2));
   int v1 = verts1.Length();
   int v2 = verts2.Length();
 
+  // find the complementary pairs of vertices; the vertices of the
+  // second polytope give player 1's strategies, and the slacks of
+  // player 2's best replies, and conversely for the first
+  int n1 = p_support.NumStrategies(1), n2 = p_support.NumStrategies(2);
+  LabelSet all(n1 + n2);
+  for (int k = 1; k <= n1 + n2; k++) {
+    all.Insert(k);
+  }
+  Array<LabelSet> labels1(v1), labels2(v2);
+  for (int i1 = 1; i1 <= v1; i1++) {
+    labels1[i1] = VertexLabels(verts1[i1], n1 + n2, n2, n1, n1, 0);
+  }
+  for (int i2 = 1; i2 <= v2; i2++) {
+    labels2[i2] = VertexLabels(verts2[i2], n1 + n2, n1, 0, n2, n1);
+  }
+
+  Array<List<int> > matches(v2);
+  VertexPairTask pairTask(labels1, labels2, all, matches);
+  if (g_numThreads > 1) {
+    RunThreads(pairTask, g_numThreads);
+  }
+  else {
+    pairTask.Run();
+  }
+
   Array<int> vert1id(v1);
   Array<int> vert2id(v2);
   for (int i = 1; i <= vert1id.Length(); vert1id[i++] = 0);
@@ -198,87 +395,71 @@ template <class T> void Solve(const StrategySupport &p_support)
     for (int i2 = 2; i2 <= v2; i2++) {
       BFS<T> bfs1 = verts2[i2];
       i++;
-      for (int i1 = 2; i1 <= v1; i1++) {
+      for (int m = 1; m <= matches[i2].Length(); m++) {
+	int i1 = matches[i2][m];
 	BFS<T> bfs2 = verts1[i1];
-	
-	// check if solution is nash 
-	// need only check complementarity, since it is feasible
-	bool nash = true;
-	for (int k = 1; nash && k <= p_support.NumStrategies(1); k++) {
-	  if (bfs1.count(k) && bfs2.count(-k)) {
-	    nash = nash && EqZero(bfs1[k] * bfs2[-k]);
+
+	MixedStrategyProfile<T> profile(p_support.NewMixedStrategyProfile<T>());
+	T sum = (T) 0;
+	for (int k = 1; k <= p_support.NumStrategies(1); k++) {
+	  profile[p_support.GetStrategy(1, k)] = (T) 0;
+	  if (bfs1.count(k)) {
+	    profile[p_support.GetStrategy(1, k)] = -bfs1[k];
+	    sum += profile[p_support.GetStrategy(1, k)];
 	  }
 	}
 
-	for (int k = 1; nash && k <= p_support.NumStrategies(2); k++) {
-	  if (bfs2.count(k) && bfs1.count(-k)) {
-	    nash = nash && EqZero(bfs2[k] * bfs1[-k]);
+	for (int k = 1; k <= p_support.NumStrategies(1); k++) {
+	  if (bfs1.count(k)) {
+	    profile[p_support.GetStrategy(1, k)] /= sum;
 	  }
 	}
 
-	if (nash) {
-	  MixedStrategyProfile<T> profile(p_support.NewMixedStrategyProfile<T>());
-	  T sum = (T) 0;
-	  for (int k = 1; k <= p_support.NumStrategies(1); k++) {
-	    profile[p_support.GetStrategy(1, k)] = (T) 0;
-	    if (bfs1.count(k)) {
-	      profile[p_support.GetStrategy(1, k)] = -bfs1[k];
-	      sum += profile[p_support.GetStrategy(1, k)];
-	    }
-	  } 
-	  
-	  for (int k = 1; k <= p_support.NumStrategies(1); k++) {
-	    if (bfs1.count(k)) { 
-	      profile[p_support.GetStrategy(1, k)] /= sum;
-	    }
+	sum = (T) 0;
+	for (int k = 1; k <= p_support.NumStrategies(2); k++) {
+	  profile[p_support.GetStrategy(2, k)] = (T) 0;
+	  if (bfs2.count(k)) {
+	    profile[p_support.GetStrategy(2, k)] = -bfs2[k];
+	    sum += profile[p_support.GetStrategy(2, k)];
 	  }
-	  
-	  sum = (T) 0;
-	  for (int k = 1; k <= p_support.NumStrategies(2); k++) {
-	    profile[p_support.GetStrategy(2, k)] = (T) 0;
-	    if (bfs2.count(k)) {
-	      profile[p_support.GetStrategy(2, k)] = -bfs2[k];
-	      sum += profile[p_support.GetStrategy(2, k)];
-	    }
-	  } 
-	  
-	  for (int k = 1; k <= p_support.NumStrategies(2); k++) {
-	    if (bfs2.count(k)) { 
-	      profile[p_support.GetStrategy(2, k)] /= sum;
-	    }
+	}
+
+	for (int k = 1; k <= p_support.NumStrategies(2); k++) {
+	  if (bfs2.count(k)) {
+	    profile[p_support.GetStrategy(2, k)] /= sum;
 	  }
+	}
+
+	PrintProfile(std::cout, "NE", profile.ToFullSupport());
 
-	  PrintProfile(std::cout, "NE", profile.ToFullSupport());
-	  
-	  // note: The keys give the mixed strategy associated with each node. 
-	  //       The keys should also keep track of the basis
-	  //       As things stand now, two different bases could lead to
-	  //       the same key... BAD!
-	  if (vert1id[i1] == 0) {
-	    id1++;
-	    vert1id[i1] = id1;
-
-	    Vector<T> probs(profile.GetSupport().NumStrategies(2));
-	    for (SupportStrategyIterator strategy = profile.GetSupport().Strategies(profile.GetGame()->GetPlayer(2));
-		 !strategy.AtEnd(); strategy++) {
-	      probs[strategy.GetIndex()] = profile[strategy];
-	    }
-	    key2.Append(probs);
+	// note: The keys give the mixed strategy associated with each node.
+	//       The keys should also keep track of the basis
+	//       As things stand now, two different bases could lead to
+	//       the same key... BAD!
+	if (vert1id[i1] == 0) {
+	  id1++;
+	  vert1id[i1] = id1;
+
+	  Vector<T> probs(profile.GetSupport().NumStrategies(2));
+	  for (SupportStrategyIterator strategy = profile.GetSupport().Strategies(profile.GetGame()->GetPlayer(2));
+	       !strategy.AtEnd(); strategy++) {
+	    probs[strategy.GetIndex()] = profile[strategy];
 	  }
-	  if (vert2id[i2] == 0) {
-	    id2++;
-	    vert2id[i2] = id2;
-
-	    Vector<T> probs(profile.GetSupport().NumStrategies(1));
-	    for (SupportStrategyIterator strategy = profile.GetSupport().Strategies(profile.GetGame()->GetPlayer(1));
-		 !strategy.AtEnd(); strategy++) {
-	      probs[strategy.GetIndex()] = profile[strategy];
-	    }
-	    key1.Append(probs);
+	  key2.Append(probs);
+	}
+	if (vert2id[i2] == 0) {
+	  id2++;
+	  vert2id[i2] = id2;
+
+	  Vector<T> probs(profile.GetSupport().NumStrategies(1));
+	  for (SupportStrategyIterator strategy = profile.GetSupport().Strategies(profile.GetGame()->GetPlayer(1));
+	       !strategy.AtEnd(); strategy++) {
+	    probs[strategy.GetIndex()] = profile[strategy];
 	  }
-	  node1.Append(vert2id[i2]);
-	  node2.Append(vert1id[i1]);
+	  key1.Append(probs);
 	}
+	node1.Append(vert2id[i2]);
+	node2.Append(vert1id[i1]);
       }
     }
     if (g_showConnect) {
@@ -290,7 +471,16 @@ template <class T> void Solve(const StrategySupport &p_support)
   }
 }
 
-extern void LrsSolve(const StrategySupport &);
+//
+// Prints the equilibria found by lrslib as they are found
+//
+class LrsPrinter : public LrsObserver {
+public:
+  virtual ~LrsPrinter() { }
+
+  void OnEquilibrium(const MixedStrategyProfile<Rational> &p_profile)
+  { PrintProfile(std::cout, "NE", p_profile); }
+};
 
 void PrintBanner(std::ostream &p_stream)
 {
@@ -311,9 +501,13 @@ void PrintHelp(char *progname)
   std::cerr << "Options:\n";
   std::cerr << "  -d DECIMALS      compute using floating-point arithmetic;\n";
   std::cerr << "                   display results with DECIMALS digits\n";
+  std::cerr << "  -H               compute in floating point, then check the\n";
+  std::cerr << "                   results in exact arithmetic\n";
   std::cerr << "  -D               don't eliminate dominated strategies first\n";
   std::cerr << "  -L               use lrslib for enumeration (experimental!)\n";
   std::cerr << "  -c               output connectedness information\n";
+  std::cerr << "  -t THREADS       number of threads used in enumeration\n";
+  std::cerr << "                   (default is 1)\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -v, --version    print version information\n";
@@ -331,7 +525,7 @@ int main(int argc, char *argv[])
     { "version", 0, NULL, 'v'  },
     { 0,    0,    0,    0   }
   };
-  while ((c = getopt_long(argc, argv, "d:DvhqcS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:DvhHLqcSt:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -348,9 +542,18 @@ int main(int argc, char *argv[])
     case 'h':
       PrintHelp(argv[0]);
       break;
+    case 'H':
+      g_hybrid = true;
+      break;
     case 'c':
       g_showConnect = true;
       break;
+    case 't':
+      g_numThreads = atoi(optarg);
+      if (g_numThreads <= 0) {
+	g_numThreads = NumProcessors();
+      }
+      break;
     case 'S':
       break;
     case 'q':
@@ -369,6 +572,11 @@ int main(int argc, char *argv[])
     }
   }
 
+  if (useFloat) {
+    // the results are in floating point already
+    g_hybrid = false;
+  }
+
   if (!quiet) {
     PrintBanner(std::cerr);
   }
@@ -404,11 +612,13 @@ int main(int argc, char *argv[])
     }
 
     if (uselrs) {
-      LrsSolve(support);
+      LrsPrinter printer;
+      LrsSolve(support, printer, g_numThreads);
     }
     else if (useFloat) {
       Solve<double>(support);
     }
+
     else {
       Solve<Rational>(support);
     }
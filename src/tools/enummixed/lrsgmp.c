@@ -0,0 +1,417 @@
+/* lrsgmp.c     library code for lrs wrapper for gmp arithmetic    */
+/* Based on lrsgmp.c from lrslib 4.2, Copyright: David Avis 2000   */
+
+/* This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+/* This file is only compiled if gmp was found by configure;
+   otherwise lrsmp.c supplies the arithmetic */
+
+#ifdef GMP
+
+#include <stdio.h>
+#include <string.h>
+#include "lrsgmp.h"
+
+/*********************************************************/
+/* Initialization and allocation procedures - must use!  */
+/******************************************************* */
+
+long
+lrs_mp_init (long dec_digits, FILE * fpin, FILE * fpout)
+/* the number of digits is unlimited, dec_digits is only recorded */
+{
+  lrs_ifp = fpin;
+  lrs_ofp = fpout;
+  lrs_record_digits = 0;
+
+  if (dec_digits <= 0)
+    dec_digits = DEFAULT_DIGITS;
+  lrs_digits = DEC2DIG (dec_digits);
+
+  return TRUE;
+}
+
+lrs_mp_vector
+lrs_alloc_mp_vector (long n)
+ /* allocate lrs_mp_vector for n+1 lrs_mp numbers */
+{
+  lrs_mp_vector p;
+  long i;
+
+  p = CALLOC ((n + 1), sizeof (lrs_mp));
+  for (i = 0; i <= n; i++)
+    mpz_init (p[i]);
+
+  return p;
+}
+
+void
+lrs_clear_mp_vector (lrs_mp_vector p, long n)
+/* free space allocated to p */
+{
+  long i;
+  for (i = 0; i <= n; i++)
+    mpz_clear (p[i]);
+  free (p);
+}
+
+lrs_mp_matrix
+lrs_alloc_mp_matrix (long m, long n)
+/* allocate lrs_mp_matrix for m+1 x n+1 lrs_mp numbers */
+{
+  lrs_mp_matrix a;
+  long i;
+
+  a = CALLOC ((m + 1), sizeof (lrs_mp_vector));
+  for (i = 0; i <= m; i++)
+    a[i] = lrs_alloc_mp_vector (n);
+
+  return a;
+}
+
+void
+lrs_clear_mp_matrix (lrs_mp_matrix p, long m, long n)
+/* free space allocated to lrs_mp_matrix p */
+{
+  long i;
+  for (i = 0; i <= m; i++)
+    lrs_clear_mp_vector (p[i], n);
+  free (p);
+}
+
+/*********************************************************/
+/* Core library functions - depend on mp implementation  */
+/******************************************************* */
+
+void
+atomp (char s[], lrs_mp a)	/*convert string to lrs_mp integer */
+{
+  long i, sig;
+  for (i = 0; s[i] == ' ' || s[i] == '\n' || s[i] == '\t'; i++);
+  /*skip white space */
+  sig = POS;
+  if (s[i] == '+' || s[i] == '-')	/* sign */
+    sig = (s[i++] == '+') ? POS : NEG;
+  if (s[i] < '0' || s[i] > '9' || mpz_set_str (a, s + i, 10) != 0)
+    {
+      fprintf (stderr, "\nIllegal character in number: '%s'\n", s + i);
+      exit (1);
+    }
+  if (sig == NEG)
+    changesign (a);
+}				/* end of atomp */
+
+void
+linint (lrs_mp a, long ka, lrs_mp b, long kb)	/*compute a*ka+b*kb --> a */
+{
+  lrs_mp t;
+  mpz_init (t);
+  mpz_mul_si (a, a, ka);
+  mpz_mul_si (t, b, kb);
+  mpz_add (a, a, t);
+  mpz_clear (t);
+}
+
+long
+mptoi (lrs_mp a)		/* convert lrs_mp to long integer */
+{
+  if (!mpz_fits_slong_p (a))
+    notimpl ("mp to large for conversion to long");
+  return mpz_get_si (a);
+}
+
+void
+pmp (const char *name, lrs_mp a)	/*print the long precision integer a */
+{
+  fprintf (lrs_ofp, "%s", name);
+  if (sign (a) != NEG)
+    fprintf (lrs_ofp, " ");
+  mpz_out_str (lrs_ofp, 10, a);
+  fprintf (lrs_ofp, " ");
+}
+
+void
+prat (const char *name, lrs_mp Nin, lrs_mp Din)	/*reduce and print Nin/Din  */
+{
+  lrs_mp Nt, Dt;
+  mpz_init_set (Nt, Nin);
+  mpz_init_set (Dt, Din);
+  reduce (Nt, Dt);
+  if (sign (Dt) == NEG)
+    {
+      changesign (Nt);
+      changesign (Dt);
+    }
+  fprintf (lrs_ofp, "%s", name);
+  if (sign (Nt) != NEG)
+    fprintf (lrs_ofp, " ");
+  mpz_out_str (lrs_ofp, 10, Nt);
+  if (!one (Dt))	/* rational */
+    {
+      fprintf (lrs_ofp, "/");
+      mpz_out_str (lrs_ofp, 10, Dt);
+    }
+  fprintf (lrs_ofp, " ");
+  mpz_clear (Nt);
+  mpz_clear (Dt);
+}
+
+void
+readmp (lrs_mp a)
+      /* read an integer and convert to lrs_mp */
+{
+  char in[MAXINPUT];
+  if (fscanf (lrs_ifp, "%s", in) != 1) {
+    exit(1);
+  }
+  atomp (in, a);
+}
+
+long
+readrat (lrs_mp Na, lrs_mp Da)
+ /* read a rational or integer and convert to lrs_mp */
+ /* returns true if denominator is not one           */
+{
+  char in[MAXINPUT], num[MAXINPUT], den[MAXINPUT];
+  if (fscanf (lrs_ifp, "%s", in) != 1) {
+    exit(1);
+  }
+  atoaa (in, num, den);		/*convert rational to num/dem strings */
+  atomp (num, Na);
+  if (den[0] == '\0')
+    {
+      itomp (1L, Da);
+      return (FALSE);
+    }
+  atomp (den, Da);
+  return (TRUE);
+}
+
+void
+reduce (lrs_mp Na, lrs_mp Da)	/* reduces Na Da by gcd(Na,Da) */
+{
+  lrs_mp Nb;
+  mpz_init (Nb);
+  mpz_gcd (Nb, Na, Da);		/* Nb is the gcd(Na,Da) */
+  if (!zero (Nb))
+    {
+      exactdivint (Na, Nb, Na);
+      exactdivint (Da, Nb, Da);
+    }
+  mpz_clear (Nb);
+}
+
+/*********************************************************/
+/* Standard arithmetic & misc. functions                 */
+/******************************************************* */
+
+long
+myrandom (long num, long nrange)
+/* return a random number in range 0..nrange-1 */
+{
+  long i;
+  i = (num * 401 + 673) % nrange;
+  return (i);
+}
+
+long
+atos (char s[])			/* convert s to integer */
+{
+  long i, j;
+  j = 0;
+  for (i = 0; s[i] >= '0' && s[i] <= '9'; ++i)
+    j = 10 * j + s[i] - '0';
+  return (j);
+}
+
+void
+stringcpy (char *s, char *t)	/*copy t to s pointer version */
+{
+  while (((*s++) = (*t++)) != '\0');
+}
+
+void
+rattodouble (lrs_mp a, lrs_mp b, double *x)	/* convert lrs_mp rational to double */
+{
+  mpq_t q;
+  mpq_init (q);
+  mpq_set_num (q, a);
+  mpq_set_den (q, b);
+  mpq_canonicalize (q);
+  *x = mpq_get_d (q);
+  mpq_clear (q);
+}
+
+void
+atoaa (char in[], char num[], char den[])
+/* convert rational string in to num/den strings */
+{
+  long i, j;
+  for (i = 0; in[i] != '\0' && in[i] != '/'; i++)
+    num[i] = in[i];
+  num[i] = '\0';
+  den[0] = '\0';
+  if (in[i] == '/')
+    {
+      for (j = 0; in[j + i + 1] != '\0'; j++)
+	den[j] = in[i + j + 1];
+      den[j] = '\0';
+    }
+}				/* end of atoaa */
+
+void
+lcm (lrs_mp a, lrs_mp b)
+/* a = least common multiple of a, b; b is preserved */
+{
+  mpz_lcm (a, a, b);
+}				/* end of lcm */
+
+void
+reducearray (lrs_mp_vector p, long n)
+/* find largest gcd of p[0]..p[n-1] and divide through */
+{
+  lrs_mp divisor;
+  long i;
+
+  mpz_init (divisor);
+  for (i = 0; i < n; i++)
+    if (!zero (p[i]))
+      mpz_gcd (divisor, divisor, p[i]);
+
+  if (!zero (divisor))
+    for (i = 0; i < n; i++)
+      if (!zero (p[i]))
+	reduceint (p[i], divisor);
+  mpz_clear (divisor);
+}				/* end of reducearray */
+
+void
+reduceint (lrs_mp Na, lrs_mp Da)	/* divide Na by Da and return */
+{
+  mpz_divexact (Na, Na, Da);
+}
+
+long
+comprod (lrs_mp Na, lrs_mp Nb, lrs_mp Nc, lrs_mp Nd)	/* +1 if Na*Nb > Nc*Nd  */
+			  /* -1 if Na*Nb < Nc*Nd  */
+			  /*  0 if Na*Nb = Nc*Nd  */
+{
+  long result;
+  lrs_mp mc, md;
+  mpz_init (mc);
+  mpz_init (md);
+  mulint (Na, Nb, mc);
+  mulint (Nc, Nd, md);
+  result = mpz_cmp (mc, md);
+  mpz_clear (mc);
+  mpz_clear (md);
+  if (result > 0)
+    return (1);
+  if (result < 0)
+    return (-1);
+  return (0);
+}
+
+void
+notimpl (char s[])
+{
+  fflush (stdout);
+  fprintf (stderr, "\nAbnormal Termination  %s\n", s);
+  exit (1);
+}
+
+void
+getfactorial (lrs_mp factorial, long k)		/* compute k factorial in lrs_mp */
+{
+  mpz_fac_ui (factorial, (k > 0) ? k : 0);
+}				/* end of getfactorial */
+
+/***************************************************************/
+/*     Package of routines for rational arithmetic             */
+/***************************************************************/
+
+void
+scalerat (lrs_mp Na, lrs_mp Da, long ka)	/* scales rational by ka */
+{
+  mpz_mul_si (Na, Na, ka);
+  reduce (Na, Da);
+}
+
+void
+linrat (lrs_mp Na, lrs_mp Da, long ka, lrs_mp Nb, lrs_mp Db, long kb, lrs_mp Nc, lrs_mp Dc)
+/* computes Nc/Dc = ka*Na/Da  +kb* Nb/Db
+   and reduces answer by gcd(Nc,Dc) */
+{
+  lrs_mp c;
+  mpz_init (c);
+  mulint (Na, Db, Nc);
+  mulint (Da, Nb, c);
+  linint (Nc, ka, c, kb);	/* Nc = (ka*Na*Db)+(kb*Da*Nb)  */
+  mulint (Da, Db, Dc);		/* Dc =  Da*Db           */
+  reduce (Nc, Dc);
+  mpz_clear (c);
+}
+
+void
+divrat (lrs_mp Na, lrs_mp Da, lrs_mp Nb, lrs_mp Db, lrs_mp Nc, lrs_mp Dc)
+ /* computes Nc/Dc = (Na/Da)  / ( Nb/Db )
+    and reduces answer by gcd(Nc,Dc) */
+{
+  mulint (Na, Db, Nc);
+  mulint (Da, Nb, Dc);
+  reduce (Nc, Dc);
+}
+
+void
+mulrat (lrs_mp Na, lrs_mp Da, lrs_mp Nb, lrs_mp Db, lrs_mp Nc, lrs_mp Dc)
+/* computes Nc/Dc = Na/Da  * Nb/Db and reduces by gcd(Nc,Dc) */
+{
+  mulint (Na, Nb, Nc);
+  mulint (Da, Db, Dc);
+  reduce (Nc, Dc);
+}
+
+/*     End package of routines for rational arithmetic         */
+
+void *
+xcalloc (long n, long s, long l, char *f)
+{
+  void *tmp;
+
+  tmp = calloc (n, s);
+  if (tmp == 0)
+    {
+      char buf[200];
+
+      sprintf (buf, "\n\nFatal error on line %ld of %s", l, f);
+      perror (buf);
+      exit (1);
+    }
+  return tmp;
+}
+
+void
+lrs_getdigits (long *a, long *b)
+{
+/* send digit information to user */
+  *a = DIG2DEC (lrs_digits);
+  *b = DIG2DEC (lrs_record_digits);
+  return;
+}
+
+#endif  /* GMP */
+
+/* end of lrsgmp.c */
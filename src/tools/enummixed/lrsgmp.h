@@ -0,0 +1,195 @@
+/* lrsgmp.h (lrs wrapper for the GNU multiple precision library)    */
+/* Based on lrsgmp.h from lrslib 4.2, Copyright: David Avis 2000     */
+
+/* This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+/******************************************************************************/
+/*  See http://cgm.cs.mcgill.ca/~avis/C/lrs.html for lrs usage instructions   */
+/******************************************************************************/
+/* This package provides the interface of lrsmp.h on top of the integers of
+   gmp, so that lrslib is compiled with arithmetic of unlimited precision.
+   Each lrs_mp number must be initialized with lrs_alloc_mp and freed with
+   lrs_clear_mp; vectors and matrices are initialized by their allocation
+   routines.  Unlike lrsmp, no global state is changed by the arithmetic,
+   so separate problems may be solved in separate threads.
+   Note that this file should not be inside an extern "C" {} block, as
+   gmp.h declares C++ functions when compiled as C++.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+
+/***********/
+/* defines */
+/***********/
+/*
+   The number of digits is unlimited; these are kept so that lrslib
+   compiles unchanged, and only appear in its messages.
+ */
+#define MAX_DIGITS 255L
+#define DEFAULT_DIGITS 100L
+
+/* MAXD is 2^(k-1)-1 where k=16,32,64 word size */
+#ifndef B64
+#define MAXD 2147483647L
+#else
+#define MAXD 9223372036854775807L
+#endif
+#define BIT "gmp"
+
+#define MAXINPUT 1000		/*max length of any input rational */
+
+#define POS 1L
+#define NEG -1L
+#ifndef TRUE
+#define TRUE 1L
+#endif
+#ifndef FALSE
+#define FALSE 0L
+#endif
+#define ONE 1L
+#define TWO 2L
+#define ZERO 0L
+
+#define DEC2DIG(d) (d)
+#define DIG2DEC(d) (d)
+
+/**********************************/
+/*         MACROS                 */
+/* dependent on mp implementation */
+/**********************************/
+
+#define addint(a, b, c)         mpz_add((c),(a),(b))
+#define changesign(a)           mpz_neg((a),(a))
+#define compare(a, b)           mpz_cmp((a),(b))
+#define copy(a, b)              mpz_set((a),(b))
+#define decint(a, b)            mpz_sub((a),(a),(b))
+#define divint(a, b, c)         mpz_tdiv_qr((c),(a),(a),(b))
+#define exactdivint(a, b, c)    mpz_divexact((c),(a),(b))
+#define gcd(a, b)               mpz_gcd((a),(a),(b))
+#define greater(a, b)           (mpz_cmp((a),(b)) > 0 ? ONE : ZERO)
+#define itomp(in, a)            mpz_set_si((a),(in))
+#define mptodouble(a, b)        (*(b) = mpz_get_d(a))
+#define mulint(a, b, c)         mpz_mul((c),(a),(b))
+#define negative(a)             (mpz_sgn(a) < 0 ? ONE : ZERO)
+#define normalize(a)            (void) 0
+#define one(a)                  (mpz_cmp_si((a),ONE) == 0 ? ONE : ZERO)
+#define positive(a)             (mpz_sgn(a) > 0 ? ONE : ZERO)
+#define sign(a)                 (mpz_sgn(a) < 0 ? NEG : POS)
+#define storesign(a, sa)        mpz_mul_si((a),(a),((sa)*mpz_sgn(a)))
+#define subint(a, b, c)         mpz_sub((c),(a),(b))
+#define zero(a)                 (mpz_sgn(a) == 0 ? ONE : ZERO)
+
+#define lrs_alloc_mp(a)         mpz_init(a)
+#define lrs_clear_mp(a)         mpz_clear(a)
+
+#ifdef SIGNALS
+#include <signal.h>
+#include <unistd.h>
+#define errcheck(s,e) if ((long)(e)==-1L){  perror(s);exit(1);}
+#endif
+
+#ifdef TIMES
+void ptimes ();
+#endif
+
+#define CALLOC(n,s) xcalloc(n,s,__LINE__,__FILE__)
+
+/*************/
+/* typedefs  */
+/*************/
+
+typedef mpz_t lrs_mp;		/* type lrs_mp holds one multi-precision integer */
+typedef mpz_t *lrs_mp_vector;
+typedef mpz_t **lrs_mp_matrix;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************/
+/*global variables   */
+/*********************/
+
+long lrs_digits;		/* max permitted no. of digits   */
+long lrs_record_digits;		/* this is the biggest acheived so far.     */
+
+FILE *lrs_ifp;			/* input file pointer       */
+FILE *lrs_ofp;			/* output file pointer      */
+
+/*********************************************************/
+/* Initialization and allocation procedures - must use!  */
+/******************************************************* */
+
+lrs_mp_vector lrs_alloc_mp_vector (long n);	/* allocate lrs_mp_vector for n+1 lrs_mp numbers */
+lrs_mp_matrix lrs_alloc_mp_matrix (long m, long n);	/* allocate lrs_mp_matrix for m+1 x n+1 lrs_mp   */
+
+void lrs_clear_mp_vector (lrs_mp_vector a, long n);
+void lrs_clear_mp_matrix (lrs_mp_matrix a, long m, long n);
+
+long lrs_mp_init (long dec_digits, FILE * lrs_ifp, FILE * lrs_ofp);	/* max number of decimal digits, fps   */
+
+/*********************************************************/
+/* Core library functions - depend on mp implementation  */
+/******************************************************* */
+void atomp (char s[], lrs_mp a);	/* convert string to lrs_mp integer               */
+void linint (lrs_mp a, long ka, lrs_mp b, long kb);	/* compute a*ka+b*kb --> a                        */
+long mptoi (lrs_mp a);		/* convert lrs_mp to long integer */
+void pmp (const char *name, lrs_mp a);	/* print the long precision integer a             */
+void prat (const char *name, lrs_mp Nt, lrs_mp Dt);	/* reduce and print  Nt/Dt                        */
+void readmp (lrs_mp a);		/* read an integer and convert to lrs_mp          */
+long readrat (lrs_mp Na, lrs_mp Da);	/* read a rational or int and convert to lrs_mp   */
+void reduce (lrs_mp Na, lrs_mp Da);	/* reduces Na Da by gcd(Na,Da)                    */
+
+/*********************************************************/
+/* Standard arithmetic & misc. functions                 */
+/* should be independent of mp implementation            */
+/******************************************************* */
+
+void atoaa (char in[], char num[], char den[]);		/* convert rational string in to num/den strings  */
+long atos (char s[]);		/* convert s to integer                           */
+long comprod (lrs_mp Na, lrs_mp Nb, lrs_mp Nc, lrs_mp Nd);	/* +1 if Na*Nb > Nc*Nd,-1 if Na*Nb > Nc*Nd else 0 */
+void divrat (lrs_mp Na, lrs_mp Da, lrs_mp Nb, lrs_mp Db, lrs_mp Nc, lrs_mp Dc);
+						       /* computes Nc/Dc = (Na/Da) /( Nb/Db ) and reduce */
+void getfactorial (lrs_mp factorial, long k);	/* compute k factorial in lrs_mp                  */
+void linrat (lrs_mp Na, lrs_mp Da, long ka, lrs_mp Nb, lrs_mp Db, long kb, lrs_mp Nc, lrs_mp Dc);
+void lcm (lrs_mp a, lrs_mp b);	/* a = least common multiple of a, b; b is saved  */
+void mulrat (lrs_mp Na, lrs_mp Da, lrs_mp Nb, lrs_mp Db, lrs_mp Nc, lrs_mp Dc);
+						       /* computes Nc/Dc=(Na/Da)*(Nb/Db) and reduce      */
+long myrandom (long num, long nrange);	/* return a random number in range 0..nrange-1    */
+void notimpl (char s[]);	/* bail out - help!                               */
+void rattodouble (lrs_mp a, lrs_mp b, double *x);	/* convert lrs_mp rational to double              */
+void reduceint (lrs_mp Na, lrs_mp Da);	/* divide Na by Da and return it                  */
+void reducearray (lrs_mp_vector p, long n);	/* find gcd of p[0]..p[n-1] and divide through by */
+void scalerat (lrs_mp Na, lrs_mp Da, long ka);	/* scales rational by ka                          */
+
+/**********************************/
+/* Miscellaneous functions        */
+/******************************** */
+
+void lrs_getdigits (long *a, long *b);	/* send digit information to user                         */
+
+void stringcpy (char *s, char *t);	/* copy t to s pointer version                            */
+
+void *xcalloc (long n, long s, long l, char *f);
+
+void digits_overflow ();
+
+#ifdef __cplusplus
+}
+#endif
+
+/* end of  lrsgmp.h (vertex enumeration using lexicographic reverse search) */
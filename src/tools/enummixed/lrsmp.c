@@ -17,6 +17,11 @@
    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
+/* This file is only compiled if gmp was not found by configure;
+   otherwise lrsgmp.c supplies the arithmetic */
+
+#ifndef GMP
+
 /******************************************************************/
 /* digit overflow is caught by digits_overflow at the end of this */
 /* file, make sure it is either user supplied or uncomment        */
@@ -980,4 +985,6 @@ lrs_default_digits_overflow ()
   exit (1);
 }
 
+#endif  /* GMP */
+
 /* end of lrsmp.c */
@@ -39,15 +39,80 @@
 #include <iostream>
 #include <cstdio>
 #include <cstring>
+#include <string>
+#include <vector>
 
 // The order of these next includes is important, because of macro definitions
 #include "libgambit/libgambit.h"
+#include "libgambit/threads.h"
+#include "lrsnash.h"
 using namespace Gambit;
 
+#ifdef GMP
+// gmp.h declares C++ functions, so must be included outside the extern "C"
+#include <gmp.h>
+#endif  // GMP
+
 extern "C" {
 #include "lrslib.h"
 }
 
+//==========================================================================
+//                Converting between Gambit and lrs numbers
+//==========================================================================
+
+//
+// Sets a to the integer p_value.  The payoffs are passed to lrs this
+// way rather than as longs, so that games with large payoffs do not
+// overflow (the limit with lrsmp is the digits it is initialized with).
+//
+static void IntegerToMP(const Integer &p_value, lrs_mp a)
+{
+  std::string s = lexical_cast<std::string>(p_value);
+  std::vector<char> buf(s.begin(), s.end());
+  buf.push_back('\0');
+  atomp(&buf[0], a);
+}
+
+//
+// Returns the decimal digits of the absolute value of a
+//
+static std::string AbsToString(lrs_mp a)
+{
+#ifdef GMP
+  std::vector<char> buf(mpz_sizeinbase(a, 10) + 2);
+  mpz_get_str(&buf[0], 10, a);
+  return std::string((buf[0] == '-') ? &buf[1] : &buf[0]);
+#else
+  // This is the printing of prat() in lrsmp.c
+  char buf[32];
+  sprintf(buf, "%lu", a[length(a) - 1]);
+  std::string s(buf);
+  for (long i = length(a) - 2; i >= 1; i--) {
+    sprintf(buf, FORMAT, a[i]);
+    s += buf;
+  }
+  return s;
+#endif  // GMP
+}
+
+static Rational MPToRational(lrs_mp Nin, lrs_mp Din)
+{
+  lrs_mp Nt, Dt;
+  lrs_alloc_mp(Nt);
+  lrs_alloc_mp(Dt);
+  copy(Nt, Nin);
+  copy(Dt, Din);
+  reduce(Nt, Dt);
+
+  std::string s = (sign(Nin) * sign(Din) == NEG) ? "-" : "";
+  s += AbsToString(Nt) + "/" + AbsToString(Dt);
+
+  lrs_clear_mp(Nt);
+  lrs_clear_mp(Dt);
+  return lexical_cast<Rational>(s);
+}
+
 //==========================================================================
 //                   Building the problem representations
 //==========================================================================
@@ -63,7 +128,7 @@ extern "C" {
 // reversing them breaks something.
 //
 
-void FillNonnegativityRows(lrs_dic *P, lrs_dat *Q, 
+void FillNonnegativityRows(lrs_dic *P, lrs_dat *Q,
 			   int firstRow, int lastRow, int n)
 {
   const int MAXCOL = 1000;     /* maximum number of columns */
@@ -86,17 +151,18 @@ void FillConstraintRows(lrs_dic *P, lrs_dat *Q,
 			const StrategySupport &p_support,
 			int p1, int p2, int firstRow)
 {
-  const int MAXCOL = 1000;     /* maximum number of columns */
-  long num[MAXCOL], den[MAXCOL];
+  long d = P->d;
+  lrs_mp_vector num = lrs_alloc_mp_vector(d + 1);
+  lrs_mp_vector den = lrs_alloc_mp_vector(d + 1);
 
   Game game = p_support.GetGame();
   Rational min = game->GetMinPayoff() - Rational(1);
   PureStrategyProfile cont = game->NewPureStrategyProfile();
 
-  for (long row = firstRow; row < firstRow + p_support.NumStrategies(p1); 
+  for (long row = firstRow; row < firstRow + p_support.NumStrategies(p1);
        row++) {
-    num[0] = 0;
-    den[0] = 1;
+    itomp(ZERO, num[0]);
+    itomp(ONE, den[0]);
 
     cont->SetStrategy(p_support.GetStrategy(p1, row - firstRow + 1));
 
@@ -104,14 +170,18 @@ void FillConstraintRows(lrs_dic *P, lrs_dat *Q,
       cont->SetStrategy(p_support.GetStrategy(p2, st));
       Rational x = cont->GetPayoff(p1) - min;
 
-      num[st] = -x.numerator().as_long();
-      den[st] = x.denominator().as_long();
+      IntegerToMP(x.numerator(), num[st]);
+      changesign(num[st]);
+      IntegerToMP(x.denominator(), den[st]);
     }
 
-    num[p_support.NumStrategies(p2)+1] = 1;
-    den[p_support.NumStrategies(p2)+1] = 1;
-    lrs_set_row(P, Q, row, num, den, GE);
+    itomp(ONE, num[p_support.NumStrategies(p2)+1]);
+    itomp(ONE, den[p_support.NumStrategies(p2)+1]);
+    lrs_set_row_mp(P, Q, row, num, den, GE);
   }
+
+  lrs_clear_mp_vector(num, d + 1);
+  lrs_clear_mp_vector(den, d + 1);
 }
 
 void FillLinearityRow(lrs_dic *P, lrs_dat *Q, int m, int n)
@@ -140,7 +210,7 @@ void BuildRep(lrs_dic *P, lrs_dat *Q, const StrategySupport &p_support,
 	      int p1, int p2)
 {
   long m=Q->m;       /* number of inequalities      */
-  long n=Q->n;       
+  long n=Q->n;
 
   if (p1 == 1) {
     FillConstraintRows(P, Q, p_support, p1, p2, 1);
@@ -155,53 +225,303 @@ void BuildRep(lrs_dic *P, lrs_dat *Q, const StrategySupport &p_support,
   FillLinearityRow(P, Q, m, n);
 }
 
+//========================================================================
+//                  Sharing out the search among threads
+//========================================================================
+
+//
+// The search of player 1's polytope is done by one thread.  At each
+// vertex it finds, player 2's polytope must be searched with the
+// linearities the vertex imposes; these searches are independent of
+// each other, and are pushed onto a stack for the other threads to do.
+// With lrsmp arithmetic, which keeps global state, or if only one thread
+// is requested, player 2's polytope is searched at each vertex directly
+// as in the original lrslib driver.
+//
+
+// A vertex of player 1's polytope, at which player 2's is to be searched
+class LrsVertex {
+public:
+  std::vector<long> linearity;   // the linearities in player 2's problem
+  Array<Rational> probs;         // player 1's strategy probabilities
+};
+
+class Player2Search;
+
+class LrsSearch {
+private:
+  const StrategySupport &m_support;
+  LrsObserver &m_observer;
+  int m_numThreads, m_n1, m_n2;
+  Mutex m_mutex;      // guards the members below, and the observer
+  int m_pending;      // number of vertices waiting on m_work
+  bool m_firstWarning, m_firstUnbounded;
+
+  LrsVertex *NewVertex(void);
+
+public:
+  lrs_dic *P1;
+  lrs_dat *Q1;
+  lrs_mp_vector output1;
+  lrs_mp_matrix Lin;
+  WorkStack<LrsVertex *> m_work;
+
+  LrsSearch(const StrategySupport &p_support, LrsObserver &p_observer,
+	    int p_numThreads);
+
+  // The reverse search of player 1's polytope; p_helper is the
+  // player 2 search of the calling thread
+  void SearchPlayer1(Player2Search &p_helper);
+  void OnPop(void) { MutexLock lock(m_mutex); m_pending--; }
+
+  // Called from the player 2 searches
+  void CheckStart(lrs_dat *Q2);
+  void OnEquilibrium(const LrsVertex &p_vertex, lrs_mp_vector output2);
+};
+
+//
+// The data for the search of player 2's polytope.  Each thread has
+// one of these, which are set up before the threads are started, since
+// allocating lrs_dat records is not thread-safe.
+//
+class Player2Search : public ThreadTask {
+private:
+  LrsSearch &m_search;
+  lrs_dat *Q2;
+  lrs_dic *P2orig;   /* player 2's dictionary, as built from the game */
+  lrs_mp_vector output2;
+
+public:
+  Player2Search(LrsSearch &p_search, const StrategySupport &p_support);
+  virtual ~Player2Search();
+
+  void Search(const LrsVertex &p_vertex);
+  void Run(void);
+};
+
 //========================================================================
 //               Forward declarations of useful functions
 //========================================================================
 
 /* lrs driver, argv[2]= 2nd input file for nash equilibria */
-long nash2_main (lrs_dic *P1, lrs_dat *Q1, lrs_dic *P2orig,
-		 lrs_dat *Q2, long *numequilib, 
-		 lrs_mp_vector output1, lrs_mp_vector output2,
-		 const StrategySupport &p_support);
+long nash2_main (LrsSearch &p_search, const LrsVertex &p_vertex,
+		 lrs_dic *P2orig, lrs_dat *Q2, lrs_mp_vector output2);
 
-long lrs_getfirstbasis2 (lrs_dic ** D_p, lrs_dat * Q, lrs_dic *P2orig,
+long lrs_getfirstbasis2 (lrs_dic ** D_p, lrs_dat * Q,
 			 lrs_mp_matrix * Lin, long no_output);
 
-long getabasis2 (lrs_dic * P, lrs_dat * Q, lrs_dic * P2orig, long order[]);
+long getabasis2 (lrs_dic * P, lrs_dat * Q, long order[]);
+
+//========================================================================
+//                  Implementation of the search classes
+//========================================================================
+
+LrsSearch::LrsSearch(const StrategySupport &p_support,
+		     LrsObserver &p_observer, int p_numThreads)
+  : m_support(p_support), m_observer(p_observer),
+    m_numThreads(p_numThreads),
+    m_n1(p_support.NumStrategies(1)), m_n2(p_support.NumStrategies(2)),
+    m_pending(0), m_firstWarning(true), m_firstUnbounded(true),
+    P1(0), Q1(0), output1(0), Lin(0)
+{ }
+
+LrsVertex *LrsSearch::NewVertex(void)
+{
+  LrsVertex *vertex = new LrsVertex;
+  long i, j;
+
+/* Here we take the linearities generated by the current vertex of player 1*/
+/* and append them to the linearity in player 2's input matrix             */
+/* next is the key magic linking player 1 and 2 */
+/* be careful if you mess with this!            */
+
+  for (i = Q1->lastdv + 1; i <= P1->m; i++) {
+    if (!zero(P1->A[P1->Row[i]][0])) {
+      j = Q1->inequality[P1->B[i]-Q1->lastdv];
+      if (j < Q1->linearity[0]) {
+	vertex->linearity.push_back(j);
+      }
+    }
+  }
+/* add back in the linearity for probs summing to one */
+  vertex->linearity.push_back(Q1->linearity[0]);
+
+  vertex->probs = Array<Rational>(m_n1);
+  for (int k = 1; k <= m_n1; k++) {
+    vertex->probs[k] = MPToRational(output1[k], output1[0]);
+  }
+  return vertex;
+}
+
+void LrsSearch::SearchPlayer1(Player2Search &p_helper)
+{
+  long col;	    /* output column index for dictionary                   */
+  long startcol = 0;
+  long prune = FALSE;		/* if TRUE, getnextbasis will prune tree and backtrack  */
 
-// This is a modified version of lrs_output from the original, in which
-// we output the equilibria found in Gambit format.
-void nashoutput(lrs_dat *Q1, lrs_mp_vector output1,
-		lrs_dat *Q2, lrs_mp_vector output2,
-		const StrategySupport &p_support);
+  if (Q1->homogeneous && Q1->hull)
+    startcol++;			/* col zero not treated as redundant   */
 
+  for (col = startcol; col < Q1->nredundcol; col++)	/* print linearity space               */
+    lrs_printoutput (Q1, Lin[col]);	/* Array Lin[][] holds the coeffs.     */
 
+  /* We initiate reverse search from this dictionary       */
+  /* getting new dictionaries until the search is complete */
+  /* User can access each output line from output which is */
+  /* vertex/ray/facet from the lrs_mp_vector output         */
+  /* prune is TRUE if tree should be pruned at current node */
+  do
+    {
+      prune=lrs_checkbound(P1,Q1);
+      if (!prune && lrs_getsolution (P1, Q1, output1, col))
+	{
+	  LrsVertex *vertex = NewVertex();
+	  if (m_numThreads == 1) {
+	    p_helper.Search(*vertex);
+	    delete vertex;
+	  }
+	  else {
+	    {
+	      MutexLock lock(m_mutex);
+	      m_pending++;
+	    }
+	    m_work.Push(vertex);
+
+	    // If the other threads are falling behind, search some of
+	    // the waiting vertices here, so the stack does not grow
+	    // without bound.
+	    while (true) {
+	      {
+		MutexLock lock(m_mutex);
+		if (m_pending <= 2 * m_numThreads)  break;
+	      }
+	      if (!m_work.TryPop(vertex))  break;
+	      OnPop();
+	      p_helper.Search(*vertex);
+	      delete vertex;
+	    }
+	  }
+	}
+    }
+  while (lrs_getnextbasis (&P1, Q1, prune));
+}
+
+void LrsSearch::CheckStart(lrs_dat *Q2)
+{
+  MutexLock lock(m_mutex);
+  if (m_firstWarning && Q2->dualdeg)
+     {
+      m_firstWarning=false;
+      printf("\n*Warning! Dual degenerate, ouput may be incomplete");
+      printf("\n*Recommendation: Add dualperturb option before maximize in second input file\n");
+     }
+  if (m_firstUnbounded && Q2->unbounded)
+     {
+      m_firstUnbounded=false;
+      printf("\n*Warning! Unbounded starting dictionary for p2, output may be incomplete");
+      printf("\n*Recommendation: Change/remove maximize option, or include bounds \n");
+     }
+}
+
+void LrsSearch::OnEquilibrium(const LrsVertex &p_vertex,
+			      lrs_mp_vector output2)
+{
+  Array<Rational> probs2(m_n2);
+  for (int k = 1; k <= m_n2; k++) {
+    probs2[k] = MPToRational(output2[k], output2[0]);
+  }
+
+  // The game and strategy handles are reference counted without
+  // locking, so the profile is built while holding the lock.
+  MutexLock lock(m_mutex);
+  MixedStrategyProfile<Rational> profile(m_support.GetGame()->NewMixedStrategyProfile(Rational(0)));
+  for (int i = 1; i <= profile.MixedProfileLength(); profile[i++] = Rational(0));
+  for (int k = 1; k <= m_n1; k++) {
+    profile[m_support.GetStrategy(1, k)] = p_vertex.probs[k];
+  }
+  for (int k = 1; k <= m_n2; k++) {
+    profile[m_support.GetStrategy(2, k)] = probs2[k];
+  }
+  m_observer.OnEquilibrium(profile);
+}
+
+Player2Search::Player2Search(LrsSearch &p_search,
+			     const StrategySupport &p_support)
+  : m_search(p_search)
+{
+  /* allocate and init structure for player 2's problem data */
+  Q2 = lrs_alloc_dat ("LRS globals");
+
+  Q2->nash=TRUE;
+  Q2->n = p_support.NumStrategies(2) + 2;
+  Q2->m = p_support.MixedProfileLength() + 1;
+
+  P2orig = lrs_alloc_dic (Q2);	/* allocate and initialize lrs_dic */
+  BuildRep(P2orig, Q2, p_support, 1, 2);
+
+  output2 = lrs_alloc_mp_vector (Q2->n + Q2->m);   /* output holds one line of output from dictionary     */
+}
+
+Player2Search::~Player2Search()
+{
+  lrs_clear_mp_vector(output2, Q2->m + Q2->n);
+
+  Q2->Qhead = P2orig;            /* reset this or you crash free_dic */
+  lrs_free_dic (P2orig,Q2);      /* deallocate lrs_dic */
+  lrs_free_dat (Q2);             /* deallocate lrs_dat */
+}
+
+void Player2Search::Search(const LrsVertex &p_vertex)
+{
+  nash2_main(m_search, p_vertex, P2orig, Q2, output2);
+}
+
+void Player2Search::Run(void)
+{
+  LrsVertex *vertex;
+  try {
+    while (m_search.m_work.Pop(vertex)) {
+      if (vertex) {
+	m_search.OnPop();
+	Search(*vertex);
+	delete vertex;
+      }
+      else {
+	// The first item pushed starts the search of player 1's polytope
+	m_search.SearchPlayer1(*this);
+      }
+      m_search.m_work.Done();
+    }
+  }
+  catch (...) {
+    m_search.m_work.Stop();
+    m_search.m_work.Done();
+    throw;
+  }
+}
 
 //
 // This is the main function, based on main() from lrslib's 'nash' driver.
 //
-void LrsSolve(const StrategySupport &p_support)
+void LrsSolve(const StrategySupport &p_support, LrsObserver &p_observer,
+	      int p_numThreads)
 {
-  lrs_dic *P1,*P2; /* structure for holding current dictionary and indices */
-  lrs_dat *Q1,*Q2; /* structure for holding static problem data            */
-
-  lrs_mp_vector output1; /* holds one line of output; ray,vertex,facet,linearity */
-  lrs_mp_vector output2; /* holds one line of output; ray,vertex,facet,linearity */
   lrs_mp_matrix Lin;	/* holds input linearities if any are found             */
 
-  lrs_dic *P2orig;  /* we will save player 2's dictionary in getabasis      */
+#ifndef GMP
+  // lrsmp keeps the precision reached in global variables
+  p_numThreads = 1;
+#endif  // GMP
+  // each thread needs an lrs_dat record, of which lrslib has a fixed number
+  if (p_numThreads > MAX_LRS_GLOBALS - 1) {
+    p_numThreads = MAX_LRS_GLOBALS - 1;
+  }
 
-  long col;	    /* output column index for dictionary                   */
-  long startcol = 0;
-  long prune = FALSE;		/* if TRUE, getnextbasis will prune tree and backtrack  */
-  long numequilib=0;            /* number of nash equilibria found                      */
-  long oldnum=0;                                                                            
 /* global variables lrs_ifp and lrs_ofp are file pointers for input and output   */
 /* they default to stdin and stdout, but may be overidden by command line parms. */
 
 /***************************************************
- Step 0: 
+ Step 0:
   Do some global initialization that should only be done once,
   no matter how many lrs_dat records are allocated. db
 
@@ -215,48 +535,31 @@ void LrsSolve(const StrategySupport &p_support)
 /* Step 1: Allocate lrs_dat, lrs_dic and set up the problem                      */
 /*********************************************************************************/
 
+  LrsSearch search(p_support, p_observer, p_numThreads);
 
-  Q1 = lrs_alloc_dat ("LRS globals");	/* allocate and init structure for static problem data */
+  lrs_dat *Q1 = lrs_alloc_dat ("LRS globals");	/* allocate and init structure for static problem data */
   if (Q1 == NULL) {
     return;
   }
 
   Q1->nash=TRUE;
-  Q1->n = p_support.NumStrategies(1) + 2;   
+  Q1->n = p_support.NumStrategies(1) + 2;
   Q1->m = p_support.MixedProfileLength() + 1;
 
-  P1 = lrs_alloc_dic (Q1);	/* allocate and initialize lrs_dic */
+  lrs_dic *P1 = lrs_alloc_dic (Q1);	/* allocate and initialize lrs_dic */
   if (P1 == NULL) {
     return;
   }
 
   BuildRep(P1, Q1, p_support, 2, 1);
 
-  output1 = lrs_alloc_mp_vector (Q1->n + Q1->m);   /* output holds one line of output from dictionary     */
+  lrs_mp_vector output1 = lrs_alloc_mp_vector (Q1->n + Q1->m);   /* output holds one line of output from dictionary     */
 
-  /* allocate and init structure for player 2's problem data */
-  Q2 = lrs_alloc_dat ("LRS globals"); 
-  if (Q2 == NULL) {
-    return;
+  Array<ThreadTask *> tasks;
+  for (int i = 1; i <= p_numThreads; i++) {
+    tasks.Append(new Player2Search(search, p_support));
   }
 
-  Q2->nash=TRUE;
-  Q2->n = p_support.NumStrategies(2) + 2;   
-  Q2->m = p_support.MixedProfileLength() + 1;
-
-  P2 = lrs_alloc_dic (Q2);	/* allocate and initialize lrs_dic */
-  if (P2 == NULL) {
-    return;
-  }
-  BuildRep(P2, Q2, p_support, 1, 2);
-
-  output2 = lrs_alloc_mp_vector (Q2->n + Q2->m);   /* output holds one line of output from dictionary     */
-
-  P2orig = lrs_getdic(Q2);  	     /* allocate and initialize lrs_dic                     */
-  if (P2orig == NULL)
-    return;
-  copy_dict(Q2,P2orig,P2);
-
 /*********************************************************************************/
 /* Step 2: Find a starting cobasis from default of specified order               */
 /*         P1 is created to hold  active dictionary data and may be cached       */
@@ -264,76 +567,56 @@ void LrsSolve(const StrategySupport &p_support)
 /*         Print linearity space if any, and retrieve output from first dict.    */
 /*********************************************************************************/
 
-  if (!lrs_getfirstbasis (&P1, Q1, &Lin, TRUE))
-    return;
-
-  if (Q1->dualdeg)
-     {
-      printf("\n*Warning! Dual degenerate, ouput may be incomplete");
-      printf("\n*Recommendation: Add dualperturb option before maximize in first input file\n");
-     }
-
-  if (Q1->unbounded)
-     {
-      printf("\n*Warning! Unbounded starting dictionary for p1, output may be incomplete");
-      printf("\n*Recommendation: Change/remove maximize option, or include bounds \n");
-     }
-
-  /* Pivot to a starting dictionary                      */
-  /* There may have been column redundancy               */
-  /* If so the linearity space is obtained and redundant */
-  /* columns are removed. User can access linearity space */
-  /* from lrs_mp_matrix Lin dimensions nredundcol x d+1  */
-
-
+  if (lrs_getfirstbasis (&P1, Q1, &Lin, TRUE)) {
+    if (Q1->dualdeg)
+      {
+	printf("\n*Warning! Dual degenerate, ouput may be incomplete");
+	printf("\n*Recommendation: Add dualperturb option before maximize in first input file\n");
+      }
 
-  if (Q1->homogeneous && Q1->hull)
-    startcol++;			/* col zero not treated as redundant   */
+    if (Q1->unbounded)
+      {
+	printf("\n*Warning! Unbounded starting dictionary for p1, output may be incomplete");
+	printf("\n*Recommendation: Change/remove maximize option, or include bounds \n");
+      }
 
-  for (col = startcol; col < Q1->nredundcol; col++)	/* print linearity space               */
-    lrs_printoutput (Q1, Lin[col]);	/* Array Lin[][] holds the coeffs.     */
+    /* Pivot to a starting dictionary                      */
+    /* There may have been column redundancy               */
+    /* If so the linearity space is obtained and redundant */
+    /* columns are removed. User can access linearity space */
+    /* from lrs_mp_matrix Lin dimensions nredundcol x d+1  */
 
 /*********************************************************************************/
 /* Step 3: Terminate if lponly option set, otherwise initiate a reverse          */
 /*         search from the starting dictionary. Get output for each new dict.    */
 /*********************************************************************************/
 
-  /* We initiate reverse search from this dictionary       */
-  /* getting new dictionaries until the search is complete */
-  /* User can access each output line from output which is */
-  /* vertex/ray/facet from the lrs_mp_vector output         */
-  /* prune is TRUE if tree should be pruned at current node */
-  do
-    {
-      prune=lrs_checkbound(P1,Q1);
-      if (!prune && lrs_getsolution (P1, Q1, output1, col))
-	{ 
-           oldnum=numequilib;
-           nash2_main(P1,Q1,P2orig,Q2,&numequilib,output1,output2,p_support);
-	   if (numequilib > oldnum || Q1->verbose)
-	      {
-                if(Q1->verbose)
-                  prat(" \np2's obj value: ",P1->objnum,P1->objden);
-       	        //fprintf (lrs_ofp, "\n");
-	      }
-	}
+    search.P1 = P1;
+    search.Q1 = Q1;
+    search.output1 = output1;
+    search.Lin = Lin;
+
+    search.m_work.Push(0);
+    if (p_numThreads > 1) {
+      RunThreads(tasks);
     }
-  while (lrs_getnextbasis (&P1, Q1, prune));
+    else {
+      tasks[1]->Run();
+    }
+    P1 = search.P1;
 
-  lrs_clear_mp_vector(output1, Q1->m + Q1->n);
-  lrs_clear_mp_vector(output2, Q2->m + Q2->n);
+  }
 
-  
-  Q2->Qhead = P2;                /* reset this or you crash free_dic */
-  lrs_free_dic (P2,Q2);          /* deallocate lrs_dic */
-  lrs_free_dat (Q2);             /* deallocate lrs_dat */
+  for (int i = 1; i <= tasks.Length(); i++) {
+    delete tasks[i];
+  }
+
+  lrs_clear_mp_vector(output1, Q1->m + Q1->n);
 
   lrs_free_dic (P1,Q1);          /* deallocate lrs_dic */
   lrs_free_dat (Q1);             /* deallocate lrs_dat */
 
-
   lrs_close ("");
-  fclose(lrs_ofp);
 }
 /*********************************************/
 /* end of nash driver                        */
@@ -345,29 +628,18 @@ void LrsSolve(const StrategySupport &p_support)
 /* equilibria on a second polytope interleaved with first */
 /**********************************************************/
 
-long nash2_main (lrs_dic *P1, lrs_dat *Q1, lrs_dic *P2orig, 
-		 lrs_dat *Q2, long *numequilib, 
-		 lrs_mp_vector output1, lrs_mp_vector output2,
-		 const StrategySupport &p_support)
-
-
+long nash2_main (LrsSearch &p_search, const LrsVertex &p_vertex,
+		 lrs_dic *P2orig, lrs_dat *Q2, lrs_mp_vector output2)
 {
 
   lrs_dic *P2;                  /* This can get resized, cached etc. Loaded from P2orig */
   lrs_mp_matrix Lin;		/* holds input linearities if any are found             */
   long col;			/* output column index for dictionary                   */
-  long startcol = 0;
   long prune = FALSE;		/* if TRUE, getnextbasis will prune tree and backtrack  */
   long nlinearity;
   long *linearity;
-  static long firstwarning=TRUE;    /* FALSE if dual deg warning for Q2 already given     */
-  static long firstunbounded=TRUE;  /* FALSE if dual deg warning for Q2 already given     */
-
-  long i,j;
-
-/* global variables lrs_ifp and lrs_ofp are file pointers for input and output   */
-/* they default to stdin and stdout, but may be overidden by command line parms. */
 
+  long i;
 
 /*********************************************************************************/
 /* Step 1: Allocate lrs_dat, lrs_dic and set up the problem                      */
@@ -378,27 +650,15 @@ long nash2_main (lrs_dic *P1, lrs_dat *Q1, lrs_dic *P2orig,
   copy_dict(Q2,P2,P2orig);
 
 /* Here we take the linearities generated by the current vertex of player 1*/
-/* and append them to the linearity in player 2's input matrix             */ 
-/* next is the key magic linking player 1 and 2 */
-/* be careful if you mess with this!            */
+/* (found in LrsSearch::NewVertex) and put them in player 2's input matrix */
 
   linearity=Q2->linearity;
   nlinearity=0;
-       for(i=Q1->lastdv+1;i <= P1->m; i++)
-        {
-           if (!zero(P1->A[P1->Row[i]][0]))
-           {
-             j =  Q1->inequality[P1->B[i]-Q1->lastdv];
-             if (j < Q1->linearity[0])
-	         linearity[nlinearity++]= j;
-	   }
-         }
-/* add back in the linearity for probs summing to one */
-       linearity[nlinearity++]= Q1->linearity[0];
-
+  for (i = 0; i < (long) p_vertex.linearity.size(); i++)
+    linearity[nlinearity++]= p_vertex.linearity[i];
 
 /*sort linearities */
-  for (i = 1; i < nlinearity; i++)	
+  for (i = 1; i < nlinearity; i++)
     reorder (linearity, nlinearity);
 
   if(Q2->verbose)
@@ -406,7 +666,7 @@ long nash2_main (lrs_dic *P1, lrs_dat *Q1, lrs_dic *P2orig,
        fprintf(lrs_ofp,"\np2: linearities %ld",nlinearity);
        for (i=0;i < nlinearity; i++)
 	       fprintf(lrs_ofp," %ld",linearity[i]);
-  }    
+  }
 
   Q2->nlinearity = nlinearity;
   Q2->polytope = FALSE;
@@ -419,37 +679,9 @@ long nash2_main (lrs_dic *P1, lrs_dat *Q1, lrs_dic *P2orig,
 /*         Print linearity space if any, and retrieve output from first dict.    */
 /*********************************************************************************/
 
-  if (!lrs_getfirstbasis2 (&P2, Q2, P2orig, &Lin, TRUE))
+  if (!lrs_getfirstbasis2 (&P2, Q2, &Lin, TRUE))
     goto sayonara;
-  if (firstwarning && Q2->dualdeg)
-     {
-      firstwarning=FALSE;
-      printf("\n*Warning! Dual degenerate, ouput may be incomplete");
-      printf("\n*Recommendation: Add dualperturb option before maximize in second input file\n");
-     }
-  if (firstunbounded && Q2->unbounded)
-     {
-      firstunbounded=FALSE;
-      printf("\n*Warning! Unbounded starting dictionary for p2, output may be incomplete");
-      printf("\n*Recommendation: Change/remove maximize option, or include bounds \n");
-     }
-
-  /* Pivot to a starting dictionary                      */
-  /* There may have been column redundancy               */
-  /* If so the linearity space is obtained and redundant */
-  /* columns are removed. User can access linearity space */
-  /* from lrs_mp_matrix Lin dimensions nredundcol x d+1  */
-
-
-
-  if (Q2->homogeneous && Q2->hull)
-    startcol++;                 /* col zero not treated as redundant   */
-
-
-  /* for (col = startcol; col < Q2->nredundcol; col++)*/	/* print linearity space               */
-    /*lrs_printoutput (Q2, Lin[col]);*/	/* Array Lin[][] holds the coeffs.     */
-
-
+  p_search.CheckStart(Q2);
 
 /*********************************************************************************/
 /* Step 3: Terminate if lponly option set, otherwise initiate a reverse          */
@@ -469,10 +701,9 @@ long nash2_main (lrs_dic *P1, lrs_dat *Q1, lrs_dic *P2orig,
         col=0;
 	if (!prune && lrs_getsolution (P2, Q2, output2, col))
 	{
-	    (*numequilib)++;
              if (Q2->verbose)
                   prat(" \np1's obj value: ",P2->objnum,P2->objden);
-	     nashoutput(Q1, output1, Q2, output2, p_support);
+	     p_search.OnEquilibrium(p_vertex, output2);
 	}
     }
   while (lrs_getnextbasis (&P2, Q2, prune));
@@ -493,7 +724,7 @@ sayonara:
 #define D (*D_p)
 
 long 
-lrs_getfirstbasis2 (lrs_dic ** D_p, lrs_dat * Q, lrs_dic * P2orig, lrs_mp_matrix * Lin, long no_output)
+lrs_getfirstbasis2 (lrs_dic ** D_p, lrs_dat * Q, lrs_mp_matrix * Lin, long no_output)
 /* gets first basis, FALSE if none              */
 /* P may get changed if lin. space Lin found    */
 /* no_output is TRUE supresses output headers   */
@@ -509,7 +740,7 @@ lrs_getfirstbasis2 (lrs_dic ** D_p, lrs_dat * Q, lrs_dic * P2orig, lrs_mp_matrix
   long hull = Q->hull;
   long m, d, lastdv, nlinearity, nredundcol;
 
-  static long ocount=0;
+  long ocount=0;
 
 
   m = D->m;
@@ -568,7 +799,7 @@ lrs_getfirstbasis2 (lrs_dic ** D_p, lrs_dat * Q, lrs_dic * P2orig, lrs_mp_matrix
 /* The inequality array is used to give the insertion order                   */
 /* and is defaulted to the last d rows when givenstart=FALSE                  */
 
-  if (!getabasis2 (D, Q,P2orig, inequality))
+  if (!getabasis2 (D, Q, inequality))
           return FALSE;
 
   if(Q->debug)
@@ -737,7 +968,7 @@ lrs_getfirstbasis2 (lrs_dic ** D_p, lrs_dat * Q, lrs_dic * P2orig, lrs_mp_matrix
 }
 /********* end of lrs_getfirstbasis  ***************/
 long 
-getabasis2 (lrs_dic * P, lrs_dat * Q, lrs_dic * P2orig, long order[])
+getabasis2 (lrs_dic * P, lrs_dat * Q, long order[])
 
 /* Pivot Ax<=b to standard form */
 /*Try to find a starting basis by pivoting in the variables x[1]..x[d]        */
@@ -761,58 +992,15 @@ getabasis2 (lrs_dic * P, lrs_dat * Q, lrs_dic * P2orig, long order[])
   long m, d, nlinearity;
   long nredundcol = 0L;		/* will be calculated here */
 
-  static long firsttime=TRUE;
-  static long *linindex;
-
   m = P->m;
   d = P->d;
   nlinearity = Q->nlinearity;
 
-  if(firsttime)
-  {
-    firsttime = FALSE;
-    linindex = (long int *) calloc ((m + d + 2), sizeof (long));
-  }
-  else     /* after first time we update the change in linearities from the last time, saving many pivots */
-  {
-    for(i=1;i<=m+d;i++)
-	  linindex[i]=FALSE;
-    if(Q->debug)
-        fprintf(lrs_ofp,"\nlindex =");
-    for(i=0;i<nlinearity;i++)
-    {
-       	  linindex[d+linearity[i]]=TRUE;
-	  if(Q->debug)
-             fprintf(lrs_ofp,"  %ld",d+linearity[i]);		   
-    }
-	  
-    for(i=1;i<=m;i++)
-    {
-	  if(linindex[B[i]])  /* pivot out unwanted linearities */
-	  {
-		  k=0;
-		  while(k<d && (linindex[C[k]] ||  zero (A[Row[i]][Col[k]])))
-			  k++;
-
-                  if (k < d)
-                  {
-	            j=i;   /* note this index changes in update, cannot use i!)*/
-
-		    if(C[k] > B[j])  /* decrease i or we may skip a linearity */
-		       i--;
-	            pivot (P, Q, j, k);
-		    update (P, Q, &j, &k);
-                   }
-		   else
-                     if(Q->debug || Q->verbose)
-		        fprintf(lrs_ofp,"\n*Couldn't remove linearity i=%ld B[i]=%ld",i,B[i]);		   
-                     /* this is not necessarily an error, eg. two identical rows/cols in payoff matrix */
-                   }
-           }
-   goto hotstart;
-  }
-
-/* standard lrs processing is done on only the first call to getabasis2 */
+/* The original nash driver did the standard lrs processing below only on */
+/* the first call, and afterwards pivoted from the dictionary of the      */
+/* previous call.  That could report profiles which are not equilibria    */
+/* when the game is degenerate, and ties each search to the one before,   */
+/* so now every search starts from the dictionary built from the game.    */
 
   if (Q->debug)
     {
@@ -829,9 +1017,8 @@ getabasis2 (lrs_dic * P, lrs_dat * Q, lrs_dic * P2orig, long order[])
 	{
 	  if (Q->debug)
 	    printA (P, Q);
-#ifndef LRS_QUIET
-	  fprintf (lrs_ofp, "\nCannot find linearity in the basis");
-#endif
+	  if (Q->debug)
+	    fprintf (lrs_ofp, "\nCannot find linearity in the basis");
 	  return FALSE;
 	}
       if (i <= m)
@@ -849,9 +1036,8 @@ getabasis2 (lrs_dic * P, lrs_dat * Q, lrs_dic * P2orig, long order[])
 	    {			/* cannot pivot linearity to cobasis */
 	      if (zero (A[Row[i]][0]))
 		{
-#ifndef LRS_QUIET
-		  fprintf (lrs_ofp, "\n*Input linearity in row %ld is redundant--skipped\n", order[j]);
-#endif
+		  if (Q->debug)
+		    fprintf (lrs_ofp, "\n*Input linearity in row %ld is redundant--skipped\n", order[j]);
 		  linearity[j] = 0;
 		}
 	      else
@@ -894,10 +1080,6 @@ getabasis2 (lrs_dic * P, lrs_dat * Q, lrs_dic * P2orig, long order[])
   Q->nredundcol = nredundcol;
   Q->lastdv = d - nredundcol;
 
-  /* if not first time we continue from here after loading dictionary */
-
-hotstart:
-
   if (Q->debug)
     {
       fprintf (lrs_ofp, "\nend of first phase of getabasis2: ");
@@ -908,10 +1090,6 @@ hotstart:
       printA (P, Q);
     }
 
-/* here we save dictionary for use next time, *before* we resize */
-
-  copy_dict(Q,P2orig,P);
-
 /* Remove linearities from cobasis for rest of computation */
 /* This is done in order so indexing is not screwed up */
 
@@ -947,72 +1125,3 @@ hotstart:
     }
   return TRUE;
 }				/*  end of getabasis2 */
-
-//==========================================================================
-//                         Outputting equilibria
-//==========================================================================
-
-// This is just a modified 'prat' from lrsmp.c
-void 
-printrat (const char *name, lrs_mp Nin, lrs_mp Din)	/*reduce and print Nin/Din  */
-{
-  lrs_mp Nt, Dt;
-  long i;
-  fprintf (stdout, "%s", name);
-/* reduce fraction */
-  copy (Nt, Nin);
-  copy (Dt, Din);
-  reduce (Nt, Dt);
-/* print out       */
-  if (sign (Nin) * sign (Din) == NEG)
-    fprintf (stdout, "-");
-  //  else
-  //  fprintf (stdout, "");
-  fprintf (stdout, "%lu", Nt[length (Nt) - 1]);
-  for (i = length (Nt) - 2; i >= 1; i--)
-    fprintf (stdout, FORMAT, Nt[i]);
-  if (!(Dt[0] == 2 && Dt[1] == 1))	/* rational */
-    {
-      fprintf (stdout, "/");
-      fprintf (stdout, "%lu", Dt[length (Dt) - 1]);
-      for (i = length (Dt) - 2; i >= 1; i--)
-	fprintf (stdout, FORMAT, Dt[i]);
-    }
-}
-
-void
-nashoutput(lrs_dat *Q1, lrs_mp_vector output1,
-	   lrs_dat *Q2, lrs_mp_vector output2,
-	   const StrategySupport &p_support)
-{
-  std::cout << "NE";
-  // The -1 is because the last entry in the vector is the payoff
-  // of the other player
-  long i = 1;
-
-  GamePlayer player1 = p_support.GetGame()->GetPlayer(1);
-  for (int j = 1; j <= player1->NumStrategies(); j++) {
-    if (p_support.Contains(player1->GetStrategy(j))) {
-      std::cout << ",";
-      printrat("", output1[i++], output1[0]);
-    }
-    else {
-      std::cout << ",0";
-    }
-  }
-
-  i = 1;
-  GamePlayer player2 = p_support.GetGame()->GetPlayer(2);
-  for (int j = 1; j <= player2->NumStrategies(); j++) {
-    if (p_support.Contains(player2->GetStrategy(j))) {
-      std::cout << ",";
-      printrat("", output2[i++], output2[0]);
-    }
-    else {
-      std::cout << ",0";
-    }
-  }
-  std::cout << std::endl;
-  fflush(stdout);
-}
-
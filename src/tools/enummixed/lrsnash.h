@@ -0,0 +1,51 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/enummixed/lrsnash.h
+// Compute Nash equilibria via enumerating extreme points, lrslib version
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LRSNASH_H
+#define LRSNASH_H
+
+#include "libgambit/libgambit.h"
+
+//
+// Receives the equilibria found by LrsSolve(), each one as soon as
+// the reverse search reaches it.  When several threads are used,
+// OnEquilibrium() is called by one thread at a time, but the order in
+// which the equilibria arrive is not fixed.
+//
+class LrsObserver {
+public:
+  virtual ~LrsObserver() { }
+
+  virtual void OnEquilibrium(const Gambit::MixedStrategyProfile<Gambit::Rational> &) = 0;
+};
+
+//
+// Enumerates the extreme equilibria of a two-player game, by the
+// reverse search of lrslib over player 1's best response polytope,
+// with a search of player 2's polytope at each vertex.  If lrslib is
+// built on GMP, the searches of player 2's polytope are shared out
+// among p_numThreads threads; otherwise, only one thread is used.
+//
+void LrsSolve(const Gambit::StrategySupport &p_support,
+	      LrsObserver &p_observer, int p_numThreads = 1);
+
+#endif  // LRSNASH_H
@@ -23,7 +23,9 @@
 #ifndef VERTENUM_H
 #define VERTENUM_H
 
+#include <vector>
 #include "libgambit/libgambit.h"
+#include "libgambit/threads.h"
 #include "liblinear/lptab.h"
 #include "liblinear/bfs.h"
 
@@ -40,10 +42,16 @@
 // The code is based on the reverse Pivoting algorithm of Avis 
 // and Fukuda, Discrete Computational Geom (1992) 8:295-313.
 //
+// If more than one thread is requested, the search tree is shared
+// out among the threads: each searches a subtree until it has visited
+// a fixed number of nodes, and then leaves the subtrees it has not
+// reached for any thread to take.  The vertices are listed in the same
+// order as by the search on one thread.
+//
 
 template <class T> class VertEnum {
 private:
-  int mult_opt,depth;
+  int mult_opt,depth,nthreads;
   int n;  // N is the number of columns, which is the # of dimensions.
   int k;  // K is the number of inequalities given.
     // Removed const on A and b (Geoff)
@@ -61,8 +69,10 @@ private:
   void Report();
   void Search(LPTableau<T> &tab);
   void DualSearch(LPTableau<T> &tab);
+  void SearchTree(LPTableau<T> &tab);
 public:
-  VertEnum(const Gambit::Matrix<T> &, const Gambit::Vector<T> &);
+  VertEnum(const Gambit::Matrix<T> &, const Gambit::Vector<T> &,
+	   int p_numThreads = 1);
   VertEnum(LPTableau<T> &);
   virtual ~VertEnum();
 
@@ -0,0 +1,317 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/gt/agggame.cc
+// Action-graph games, for Gametracer
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <algorithm>
+#include <climits>
+#include "libgambit/libgambit.h"
+#include "gamefile.h"
+#include "agggame.h"
+
+static std::vector<int> ActionCounts(const std::vector<std::vector<int> > &nodes)
+{
+  std::vector<int> actions(nodes.size());
+  for (size_t i = 0; i < nodes.size(); i++) {
+    actions[i] = nodes[i].size();
+  }
+  return actions;
+}
+
+agggame::agggame(const std::vector<std::vector<int> > &nodes,
+		 const std::vector<std::vector<int> > &neighbours)
+  : gnmgame(nodes.size(), &ActionCounts(nodes)[0]),
+    numNodes(neighbours.size()), nodes(nodes), neighbours(neighbours),
+    position(neighbours.size(), std::vector<int>(neighbours.size(), -1)),
+    stride(neighbours.size()), payoffs(neighbours.size())
+{
+  for(int v = 0; v < numNodes; v++) {
+    long weight = 1;
+    for(size_t i = 0; i < neighbours[v].size(); i++) {
+      position[v][neighbours[v][i]] = i;
+      stride[v].push_back(weight);
+      weight *= numPlayers + 1;
+    }
+  }
+}
+
+agggame::~agggame()
+{ }
+
+bool agggame::isRepresentable(int numPlayers,
+			      const std::vector<std::vector<int> > &neighbours) {
+  for(size_t v = 0; v < neighbours.size(); v++) {
+    long weight = 1;
+    for(size_t i = 0; i < neighbours[v].size(); i++) {
+      if(weight > LONG_MAX / (numPlayers + 1))
+	return false;
+      weight *= numPlayers + 1;
+    }
+  }
+  return true;
+}
+
+long agggame::encode(int v, const configuration &c) {
+  long code = 0;
+  for(size_t i = 0; i < c.size(); i++)
+    code += c[i] * stride[v][i];
+  return code;
+}
+
+void agggame::setPayoff(int v, const configuration &c, double payoff) {
+  payoffs[v][encode(v, c)] = payoff;
+}
+
+double agggame::lookup(int v, long c) {
+  std::map<long, double>::const_iterator it = payoffs[v].find(c);
+  return (it == payoffs[v].end()) ? 0.0 : it->second;
+}
+
+bool agggame::isComplete() {
+  cvector s(numActions);
+  for(int n = 0; n < numPlayers; n++) {
+    for(int i = firstAction(n); i < lastAction(n); i++)
+      s[i] = 1.0 / actions[n];
+  }
+  distribution d;
+  for(int n = 0; n < numPlayers; n++) {
+    for(int a = 0; a < actions[n]; a++) {
+      int v = nodes[n][a];
+      othersDistribution(d, v, n, s);
+      for(distribution::const_iterator it = d.begin(); it != d.end(); ++it) {
+	long c = it->first;
+	if(position[v][v] >= 0)
+	  c += stride[v][position[v][v]];
+	if(payoffs[v].find(c) == payoffs[v].end())
+	  return false;
+      }
+    }
+  }
+  return true;
+}
+
+void agggame::normalize() {
+  double min = 0.0, max = 0.0;
+  bool first = true;
+  std::map<long, double>::iterator it;
+  for(int v = 0; v < numNodes; v++) {
+    for(it = payoffs[v].begin(); it != payoffs[v].end(); ++it) {
+      if(first || it->second < min)
+	min = it->second;
+      if(first || it->second > max)
+	max = it->second;
+      first = false;
+    }
+  }
+  if(max > min) {
+    for(int v = 0; v < numNodes; v++) {
+      for(it = payoffs[v].begin(); it != payoffs[v].end(); ++it)
+	it->second = (it->second - min) / (max - min);
+    }
+  }
+}
+
+double agggame::getPurePayoff(int player, int *s) {
+  int v = nodes[player][s[player]];
+  long c = 0;
+  for(int n = 0; n < numPlayers; n++) {
+    int pos = position[v][nodes[n][s[n]]];
+    if(pos >= 0)
+      c += stride[v][pos];
+  }
+  return lookup(v, c);
+}
+
+// Adds a player to the distribution d of the configuration of the
+// neighbourhood of node v.  Only the position of the player's node
+// in the neighbourhood matters, so the player's mixed strategy is
+// first projected onto the neighbourhood.
+void agggame::addPlayer(distribution &d, int v, int player, cvector &s) {
+  int k = neighbours[v].size();
+  // proj[k] is the probability of choosing a node outside the neighbourhood
+  std::vector<double> proj(k + 1, 0.0);
+  for(int a = 0; a < actions[player]; a++) {
+    int pos = position[v][nodes[player][a]];
+    proj[(pos >= 0) ? pos : k] += s[firstAction(player) + a];
+  }
+
+  distribution next;
+  for(distribution::const_iterator it = d.begin(); it != d.end(); ++it) {
+    for(int pos = 0; pos <= k; pos++) {
+      if(proj[pos] == 0.0)
+	continue;
+      next[it->first + ((pos < k) ? stride[v][pos] : 0)] += it->second * proj[pos];
+    }
+  }
+  d.swap(next);
+}
+
+// Computes in d the distribution of the configuration of the
+// neighbourhood of node v made by the players other than player.
+void agggame::othersDistribution(distribution &d, int v, int player, cvector &s) {
+  d.clear();
+  d[0] = 1.0;
+  for(int n = 0; n < numPlayers; n++) {
+    if(n != player)
+      addPlayer(d, v, n, s);
+  }
+}
+
+// The expected payoff of choosing node v, when the configuration made
+// by the other players is distributed as d, and one more player
+// chooses the node at position other of the neighbourhood (or none,
+// if other is -1).
+double agggame::expectedPayoff(const distribution &d, int v, int other) {
+  double payoff = 0.0;
+  long extra = 0;
+  if(position[v][v] >= 0)
+    extra += stride[v][position[v][v]];
+  if(other >= 0)
+    extra += stride[v][other];
+  for(distribution::const_iterator it = d.begin(); it != d.end(); ++it)
+    payoff += it->second * lookup(v, it->first + extra);
+  return payoff;
+}
+
+double agggame::getMixedPayoff(int player, cvector &s) {
+  double payoff = 0.0;
+  distribution d;
+  for(int a = 0; a < actions[player]; a++) {
+    if(s[firstAction(player) + a] == 0.0)
+      continue;
+    int v = nodes[player][a];
+    othersDistribution(d, v, player, s);
+    payoff += s[firstAction(player) + a] * expectedPayoff(d, v, -1);
+  }
+  return payoff;
+}
+
+// The entry in the row of action a of player n and the column of
+// action b of player m is the expected payoff of a when m chooses b.
+// For each m, the distribution made by the players other than n and m
+// is built from that of the players before m, which is kept as m
+// increases.  The entry depends on b only through the position of its
+// node in the neighbourhood of a's node, so each position is
+// evaluated once.
+void agggame::payoffMatrix(cmatrix &dest, cvector &s, double fuzz) {
+  int n, m, rowi, coli;
+  double fuzzcount;
+  distribution prefix, rest;
+  std::vector<double> value;
+  for(n = 0; n < numPlayers; n++) {
+    fuzzcount = fuzz;
+    for(rowi = firstAction(n); rowi < lastAction(n); rowi++) {
+      for(coli = firstAction(n); coli < lastAction(n); coli++) {
+	dest[rowi][coli] = fuzzcount;
+	fuzzcount += fuzz;
+      }
+    }
+
+    for(int a = 0; a < actions[n]; a++) {
+      int v = nodes[n][a], k = neighbours[v].size();
+      rowi = firstAction(n) + a;
+      prefix.clear();
+      prefix[0] = 1.0;
+      for(m = 0; m < numPlayers; m++) {
+	if(m == n)
+	  continue;
+	rest = prefix;
+	for(int j = m + 1; j < numPlayers; j++) {
+	  if(j != n)
+	    addPlayer(rest, v, j, s);
+	}
+	value.assign(k + 1, 0.0);
+	std::vector<bool> done(k + 1, false);
+	for(int b = 0; b < actions[m]; b++) {
+	  int pos = position[v][nodes[m][b]];
+	  int i = (pos >= 0) ? pos : k;
+	  if(!done[i]) {
+	    value[i] = expectedPayoff(rest, v, pos);
+	    done[i] = true;
+	  }
+	  dest[rowi][firstAction(m) + b] = value[i];
+	}
+	addPlayer(prefix, v, m, s);
+      }
+    }
+  }
+}
+
+//
+// The action-graph game file format
+//
+agggame *ReadAggGame(std::istream &p_stream)
+{
+  std::string token;
+  ExpectToken(p_stream, "1");
+  // the title
+  if (!ReadToken(p_stream, token)) {
+    throw Gambit::InvalidFileException();
+  }
+  int numPlayers = ReadInteger(p_stream, 1);
+  int numNodes = ReadInteger(p_stream, 1);
+
+  // The action sets of the players, and then the neighbourhoods of
+  // the nodes, each as a list of distinct node numbers
+  std::vector<std::vector<int> > lists(numPlayers + numNodes);
+  for (size_t i = 0; i < lists.size(); i++) {
+    lists[i] = ReadIntegerList(p_stream);
+    for (size_t j = 0; j < lists[i].size(); j++) {
+      if (lists[i][j] > numNodes ||
+	  std::find(lists[i].begin(), lists[i].begin() + j, lists[i][j] - 1) != lists[i].begin() + j) {
+	throw Gambit::InvalidFileException();
+      }
+      lists[i][j]--;
+    }
+    if (i < (size_t) numPlayers && lists[i].empty()) {
+      throw Gambit::InvalidFileException();
+    }
+  }
+  if (!agggame::isRepresentable(numPlayers, std::vector<std::vector<int> >(lists.begin() + numPlayers, lists.end()))) {
+    throw Gambit::InvalidFileException();
+  }
+  agggame *game = new agggame(std::vector<std::vector<int> >(lists.begin(), lists.begin() + numPlayers),
+			      std::vector<std::vector<int> >(lists.begin() + numPlayers, lists.end()));
+
+  try {
+    // The payoffs of each node, as a brace-delimited list of pairs of
+    // a configuration and a payoff
+    for (int v = 0; v < numNodes; v++) {
+      ExpectToken(p_stream, "{");
+      for (p_stream >> std::ws; p_stream.peek() == '{'; p_stream >> std::ws) {
+	agggame::configuration c(ReadIntegerList(p_stream, 0));
+	if (c.size() != lists[numPlayers + v].size() ||
+	    (!c.empty() && *std::max_element(c.begin(), c.end()) > numPlayers)) {
+	  throw Gambit::InvalidFileException();
+	}
+	game->setPayoff(v, c, ReadPayoff(p_stream));
+      }
+      ExpectToken(p_stream, "}");
+    }
+    if (!game->isComplete()) {
+      throw Gambit::InvalidFileException();
+    }
+  }
+  catch (...) {
+    delete game;
+    throw;
+  }
+  return game;
+}
@@ -0,0 +1,99 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/gt/agggame.h
+// Action-graph games, for Gametracer
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef __AGGGAME_H
+#define __AGGGAME_H
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include "gnmgame.h"
+#include "cmatrix.h"
+
+// An action-graph game.  The actions of the players are nodes of a
+// graph, which several players may share.  The payoff to a player
+// who chooses a node depends only on the configuration of the node's
+// neighbourhood, that is, on how many players choose each of the
+// nodes to which it is joined.  Since the players are anonymous,
+// the expected payoffs can be computed from the distribution of the
+// configuration, which is built up one player at a time, in time
+// polynomial in the number of players, where the table of the
+// equivalent strategic game grows exponentially.
+class agggame : public gnmgame {
+ public:
+  typedef std::vector<int> configuration;
+
+  // nodes[i][a] is the node of player i's action a; neighbours[v]
+  // lists the nodes in the neighbourhood of node v.  Each configuration
+  // is stored as an integer, so (number of players + 1) raised to the
+  // size of each neighbourhood must be less than LONG_MAX (see
+  // isRepresentable()).
+  agggame(const std::vector<std::vector<int> > &nodes,
+	  const std::vector<std::vector<int> > &neighbours);
+  ~agggame();
+
+  static bool isRepresentable(int numPlayers,
+			      const std::vector<std::vector<int> > &neighbours);
+
+  // Sets the payoff to a player who chooses node v, when the numbers
+  // of players choosing the nodes of v's neighbourhood, that player
+  // included, are given by c.  The payoff of a configuration for
+  // which none is set is zero.
+  void setPayoff(int v, const configuration &c, double payoff);
+
+  // Returns true if a payoff is set for every configuration that
+  // can arise.
+  bool isComplete();
+
+  // Rescales the payoffs so they lie between 0 and 1.
+  void normalize();
+
+  double getPurePayoff(int player, int *s);
+  double getMixedPayoff(int player, cvector &s);
+  void payoffMatrix(cmatrix &dest, cvector &s, double fuzz);
+
+ private:
+  // Configurations of the neighbourhood of a node are coded as
+  // integers, the count at position i having weight stride[v][i]
+  typedef std::map<long, double> distribution;
+
+  long encode(int v, const configuration &c);
+  void addPlayer(distribution &d, int v, int player, cvector &s);
+  void othersDistribution(distribution &d, int v, int player, cvector &s);
+  double expectedPayoff(const distribution &d, int v, int other);
+  double lookup(int v, long c);
+
+  int numNodes;
+  std::vector<std::vector<int> > nodes, neighbours;
+  // position[v][w] is the index of node w in the neighbourhood of
+  // node v, or -1 if w is not in it
+  std::vector<std::vector<int> > position;
+  std::vector<std::vector<long> > stride;
+  std::vector<std::map<long, double> > payoffs;
+};
+
+// Reads a game in the action-graph game file format, following its
+// first token AGG.  Throws Gambit::InvalidFileException if the file
+// is not in that format.
+agggame *ReadAggGame(std::istream &p_stream);
+
+#endif
@@ -22,6 +22,14 @@
 #include "float.h"
 #include "libgambit/matrix.h"
 
+#ifdef HAVE_LAPACK
+extern "C" {
+  void dgetrf_(int *m, int *n, double *a, int *lda, int *ipiv, int *info);
+  void dgetrs_(char *trans, int *n, int *nrhs, double *a, int *lda,
+	       int *ipiv, double *b, int *ldb, int *info);
+}
+#endif  // HAVE_LAPACK
+
 cvector::~cvector() { delete []x; }
 // adopted from NRiC, pg 45
 
@@ -181,6 +189,87 @@ double *cmatrix::solve(const double *b, bool &worked) const {
 	return ret;
 }
 
+#ifdef HAVE_LAPACK
+
+// LAPACK stores matrices by columns, so it sees, and factors, the
+// transpose of this matrix; LUsolve then solves with the transpose
+// of the factors.
+double cmatrix::LUfactor(int *ix) {
+	assert(m == n);
+	int nn = n, info;
+	dgetrf_(&nn, &nn, x, &nn, ix, &info);
+	if (info > 0) return 0.0;
+	double det = 1.0;
+	for(int i=0;i<n;i++) {
+		det *= x[i*n+i];
+		if (ix[i] != i+1) det = -det;
+	}
+	return det;
+}
+
+void cmatrix::LUsolve(const int *ix, cvector &b) const {
+	assert(m == n && b.m == n);
+	char trans = 'T';
+	int nn = n, nrhs = 1, info;
+	dgetrs_(&trans, &nn, &nrhs, x, &nn, (int *) ix, b.x, &nn, &info);
+}
+
+#else
+
+double cmatrix::LUfactor(int *ix) {
+	assert(m == n);
+	int i,j,k,p;
+	double det = 1.0, big, l, dum;
+	for(j=0;j<n;j++) {
+		p = j;
+		big = fabs(x[j*n+j]);
+		for(i=j+1;i<n;i++) {
+			if (fabs(x[i*n+j]) > big) {
+				big = fabs(x[i*n+j]);
+				p = i;
+			}
+		}
+		ix[j] = p;
+		if (big == 0.0) return 0.0;
+		if (p != j) {
+			for(k=0;k<n;k++) {
+				dum = x[p*n+k];
+				x[p*n+k] = x[j*n+k];
+				x[j*n+k] = dum;
+			}
+			det = -det;
+		}
+		det *= x[j*n+j];
+		for(i=j+1;i<n;i++) {
+			l = (x[i*n+j] /= x[j*n+j]);
+			if (l != 0.0)
+				for(k=j+1;k<n;k++) x[i*n+k] -= l*x[j*n+k];
+		}
+	}
+	return det;
+}
+
+void cmatrix::LUsolve(const int *ix, cvector &b) const {
+	assert(m == n && b.m == n);
+	int i,k;
+	double dum;
+	for(i=0;i<n;i++) {
+		if (ix[i] != i) {
+			dum = b.x[ix[i]];
+			b.x[ix[i]] = b.x[i];
+			b.x[i] = dum;
+		}
+	}
+	for(i=1;i<n;i++)
+		for(k=0;k<i;k++) b.x[i] -= x[i*n+k]*b.x[k];
+	for(i=n-1;i>=0;i--) {
+		for(k=i+1;k<n;k++) b.x[i] -= x[i*n+k]*b.x[k];
+		b.x[i] /= x[i*n+i];
+	}
+}
+
+#endif  // HAVE_LAPACK
+
 double cmatrix::pythag(double a, double b) {
 	double absa,absb;
 	absa = fabs(a);
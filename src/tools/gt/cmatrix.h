@@ -780,6 +780,16 @@ bool solve(cvector &b, cvector &dest);
 	cmatrix inv(bool &worked) const;
 	inline cmatrix inv() const { bool w; return inv(w); }
 	double adjoint();
+
+	// LU factorization with partial pivoting, in place, for repeated
+	// solves with the same matrix.  ix (of length n) receives the
+	// row interchanges.  Returns the determinant; if this is zero,
+	// the factorization is incomplete and must not be used.
+	// If configured with LAPACK, dgetrf and dgetrs do the work.
+	double LUfactor(int *ix);
+	// solves Ax=b in place, with the factors from LUfactor
+	void LUsolve(const int *ix, cvector &b) const;
+
 	inline double trace();
 	double testAdjoint();
 	inline void multiply(const cvector &source, cvector &dest) {
@@ -0,0 +1,149 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/gt/gamefile.cc
+// Reading games in the Gametracer file formats
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cctype>
+#include <cstdlib>
+#include "libgambit/libgambit.h"
+#include "gamefile.h"
+#include "localgame.h"
+#include "agggame.h"
+
+bool IsGametracerFile(const std::string &p_text)
+{
+  size_t start = p_text.find_first_not_of(" \t\r\n");
+  return (start != std::string::npos && 
+	  (p_text.compare(start, 5, "LOCAL") == 0 ||
+	   p_text.compare(start, 3, "AGG") == 0));
+}
+
+gnmgame *ReadGametracerGame(std::istream &p_stream, bool p_normalize)
+{
+  std::string token;
+  if (!ReadToken(p_stream, token)) {
+    throw Gambit::InvalidFileException();
+  }
+  if (token == "LOCAL") {
+    localgame *game = ReadLocalGame(p_stream);
+    if (p_normalize) game->normalize();
+    return game;
+  }
+  else if (token == "AGG") {
+    agggame *game = ReadAggGame(p_stream);
+    if (p_normalize) game->normalize();
+    return game;
+  }
+  throw Gambit::InvalidFileException();
+}
+
+bool ReadToken(std::istream &p_stream, std::string &p_token)
+{
+  char c;
+  p_token = "";
+  do {
+    if (!p_stream.get(c)) return false;
+  } while (isspace(c));
+
+  if (c == '{' || c == '}') {
+    p_token = c;
+  }
+  else if (c == '"') {
+    while (p_stream.get(c) && c != '"') {
+      if (c == '\\' && !p_stream.get(c)) break;
+      p_token += c;
+    }
+  }
+  else {
+    do {
+      p_token += c;
+    } while (p_stream.get(c) && !isspace(c) && c != '{' && c != '}');
+    if (c == '{' || c == '}') p_stream.putback(c);
+  }
+  return true;
+}
+
+void ExpectToken(std::istream &p_stream, const std::string &p_expected)
+{
+  std::string token;
+  if (!ReadToken(p_stream, token) || token != p_expected) {
+    throw Gambit::InvalidFileException();
+  }
+}
+
+static bool ParseInteger(const std::string &p_token, int p_minimum, int &p_value)
+{
+  char *end;
+  long value = strtol(p_token.c_str(), &end, 10);
+  if (end == p_token.c_str() || *end != '\0' || value < p_minimum) {
+    return false;
+  }
+  p_value = value;
+  return true;
+}
+
+int ReadInteger(std::istream &p_stream, int p_minimum)
+{
+  std::string token;
+  int value;
+  if (!ReadToken(p_stream, token) || !ParseInteger(token, p_minimum, value)) {
+    throw Gambit::InvalidFileException();
+  }
+  return value;
+}
+
+std::vector<int> ReadIntegerList(std::istream &p_stream, int p_minimum)
+{
+  ExpectToken(p_stream, "{");
+  std::vector<int> list;
+  std::string token;
+  int value;
+  while (ReadToken(p_stream, token) && token != "}") {
+    if (!ParseInteger(token, p_minimum, value)) {
+      throw Gambit::InvalidFileException();
+    }
+    list.push_back(value);
+  }
+  if (token != "}") {
+    throw Gambit::InvalidFileException();
+  }
+  return list;
+}
+
+double ReadPayoff(std::istream &p_stream)
+{
+  std::string token;
+  if (!ReadToken(p_stream, token)) {
+    throw Gambit::InvalidFileException();
+  }
+  char *end;
+  double value = strtod(token.c_str(), &end);
+  if (*end == '/') {
+    char *denom = end + 1;
+    value /= strtod(denom, &end);
+    if (end == denom) {
+      throw Gambit::InvalidFileException();
+    }
+  }
+  if (end == token.c_str() || *end != '\0') {
+    throw Gambit::InvalidFileException();
+  }
+  return value;
+}
@@ -0,0 +1,63 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/gt/gamefile.h
+// Reading games in the Gametracer file formats
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef __GAMEFILE_H
+#define __GAMEFILE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "gnmgame.h"
+
+// Returns true if the text begins as a file in one of the formats
+// read by ReadGametracerGame() does, rather than as a Gambit game file.
+bool IsGametracerFile(const std::string &p_text);
+
+// Reads a game in the local game or the action-graph game file format.
+// If p_normalize is true, the payoffs are rescaled to lie between 0
+// and 1.  Throws Gambit::InvalidFileException if the file is in
+// neither format.
+gnmgame *ReadGametracerGame(std::istream &p_stream, bool p_normalize);
+
+//
+// Tokens of the file formats, for use by the readers of each format.
+// The tokens are the braces, quoted strings (returned without their
+// quotes), and runs of other characters not separated by whitespace.
+// Each function throws Gambit::InvalidFileException if the stream
+// does not hold what is expected.
+//
+
+// Reads the next token, returning false at the end of the stream
+bool ReadToken(std::istream &p_stream, std::string &p_token);
+
+void ExpectToken(std::istream &p_stream, const std::string &p_expected);
+
+// Reads an integer no less than p_minimum
+int ReadInteger(std::istream &p_stream, int p_minimum);
+
+// Reads a brace-delimited list of integers no less than p_minimum
+std::vector<int> ReadIntegerList(std::istream &p_stream, int p_minimum = 1);
+
+// Reads a payoff, which may be written as a decimal or a fraction
+double ReadPayoff(std::istream &p_stream);
+
+#endif
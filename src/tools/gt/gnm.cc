@@ -38,6 +38,43 @@ void PrintProfile(std::ostream &p_stream,
   p_stream << std::endl;
 }
 
+// the observer used when GNM is not given one
+class gnmprinter : public gnmobserver {
+ public:
+  void onEquilibrium(const cvector &sigma)
+    { PrintProfile(std::cout, "NE", sigma); }
+  void onPoint(const std::string &label, const cvector &sigma)
+    { PrintProfile(std::cout, label, sigma); }
+};
+
+// Sets J to the LU factors of the Jacobian Dpsi = I-((I+DG)*R) of the
+// vector field, and returns its determinant.  In the rare case that
+// Dpsi is singular, J is set instead to the adjoint of Dpsi, and ix to
+// null.
+static double factorJacobian(cmatrix &J, int *&ix, int *ixstore,
+			     const cmatrix &I, const cmatrix &DG,
+			     const cmatrix &R)
+{
+  J = I;
+  J += DG;
+  J *= R;
+  J -= I;
+  J.negate();
+  // J = I-((I+DG)*R);
+  ix = ixstore;
+  double det = J.LUfactor(ix);
+  if(det == 0.0) {
+    J = I;
+    J += DG;
+    J *= R;
+    J -= I;
+    J.negate();
+    ix = 0;
+    det = J.adjoint();
+  }
+  return det;
+}
+
 // gnm(A,g,Eq,steps,fuzz,LNMFreq,LNMMax,LambdaMin,wobble,threshold)
 // ----------------------------------------------------------------
 // This executes the GNM algorithm on game A.
@@ -63,8 +100,13 @@ void PrintProfile(std::ostream &p_stream,
 // threshold: the equilibrium error threshold for doing a wobble.  If
 //            wobbles are disabled, GNM will terminate if the error
 //            reaches this threshold.
+// observer: receives the equilibria found, and may stop the search.
+//
+// If start is not null, the path starts from that profile rather
+// than from the pure equilibrium far out along g, and g is set as
+// described in gnm.h.
 
-int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold) {
+static int trace(gnmgame &A, cvector &g, const cvector *start, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold, gnmobserver *observer) {
   int i, // utility variables
     bestAction,  
     k, 
@@ -75,6 +117,7 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
     s_hat, // the next pure strategy to enter or leave the support
     Index = 1, // index of the equilibrium we're moving towards
     numEq = 0, // number of equilibria found so far
+    orient = 1, // direction of travel along the path; 0 until known
     stepsLeft; // number of linear steps remaining until we hit the boundary
 
   int N = A.getNumPlayers(), 
@@ -92,7 +135,14 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
     ee,
     V = 0.0; // scale factor for perturbation
 
+  gnmprinter printer;
+  if (!observer) {
+    observer = &printer;
+  }
+
   std::vector<int> s(M); // current best responses
+  std::vector<int> ixstore(M); // row interchanges of the factors in J
+  int *ix; // as ixstore, or null if J holds the adjoint
   std::vector<int> B(M); // current support
 
   for (int i = 0; i < M; B[i++] = 0);
@@ -101,7 +151,7 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
     R(M,M), // jacobian of the retraction operator
     I(M,M,1,1), // identity
     Dpsi, // jacobian of the cvector field
-    J(M,M); // adjoint of Dpsi
+    J(M,M); // LU factors (or adjoint) of Dpsi
 
   cvector sigma(M), // current strategy profile
     g0(M), // original perturbation ray
@@ -121,6 +171,42 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
   // INITIALIZATION
   Eq = (cvector **)malloc(sizeof(cvector *));
 
+  if(start) {
+    // Choose g so that start is an equilibrium of the game perturbed
+    // by it: each player's actions in the support of start are made
+    // best responses with equal payoffs, and the others are made
+    // worse by 1.  The path through start is followed towards lambda
+    // = 0, in whichever direction that is.
+    for(i = 0; i < M; i++) {
+      B[i] = ((*start)[i] > fuzz);
+    }
+    sigma = *start;
+    sigma.support(B);
+    A.normalizeStrategy(sigma);
+    A.payoffMatrix(DG, sigma, fuzz);
+    DG.multiply(sigma, v);
+    v /= (double)(N-1);
+    for(n = 0; n < N; n++) {
+      bestPayoff = v[A.firstAction(n)];
+      s[n] = -1;
+      for(i = A.firstAction(n); i < A.lastAction(n); i++) {
+	if(v[i] > bestPayoff)
+	  bestPayoff = v[i];
+	if(B[i] && (s[n] < 0 || v[i] > v[s[n]]))
+	  s[n] = i;
+      }
+      for(i = A.firstAction(n); i < A.lastAction(n); i++) {
+	g[i] = bestPayoff - v[i] - (B[i] ? 0.0 : 1.0);
+      }
+    }
+    lambda = 1.0;
+    orient = 0;
+
+    if (g_verbose) {
+      observer->onPoint("start", sigma);
+    }
+  }
+  else {
   // Find the lone equilibrium of the perturbed game
   for(n = 0; n < N; n++) {
     bestPayoff = g[A.firstAction(n)];
@@ -143,7 +229,7 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
   }
 
   if (g_verbose) {
-    PrintProfile(std::cout, "start", sigma);
+    observer->onPoint("start", sigma);
   }
 
   A.payoffMatrix(DG, sigma, fuzz);
@@ -170,6 +256,7 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
   lambda = 1.0;  // we scale g instead
   V = V+1; // a little extra padding
   g *= V;
+  }
 /*
   for(n = 0; n < N; n++) {
     yn1[n] = v[s[n]]; // yn1[n] is the payoff n receives for the action we wish to make dominant
@@ -204,26 +291,29 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 
   // this outer while loop executes once for each support boundary
   // that the path crosses.
-  while(1) {
+  while(!observer->isDone()) {
     k = 0; // iteration counter; when k reaches LNMFreq, run LNM
      // within a single boundary, support unchanged
 
     // take the specified number of steps within these support boundaries.  
     for(stepsLeft = steps; stepsLeft > 0; stepsLeft--) { 
-      //find J = Adj psi
-      J = I;
-      J += DG;
-      J *= R;
-      J -= I;
-      J.negate();
-      // J = I-((I+DG)*R);
-      det = J.adjoint(); // sets J = adjoint(J)
+      // factor Dpsi; its adjoint is det * inverse(Dpsi)
+      det = factorJacobian(J, ix, &ixstore[0], I, DG, R);
+      if(orient == 0) {
+	orient = (det > 0.0) ? 1 : -1;
+      }
 
       // find derivatives of z and lambda
-      J.multiply(g,dz);
-      dz.negate();      
-       //dz = -(J*g);
-      dlambda = -det;
+      if(ix) {
+	dz = g;
+	J.LUsolve(ix, dz);
+	dz *= -det * orient;
+      } else {
+	J.multiply(g,dz);
+	dz *= -orient;
+      }
+       //dz = -(Adj(Dpsi)*g);
+      dlambda = -det * orient;
       R.multiply(dz, ym1);
       DG.multiply(ym1,dv);
       //dv = (DG*(R*dz));
@@ -296,14 +386,8 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 	  ee = 0.0;
 	  if(N > 2) { // if N=2, the graph is linear, so we are at a
 	    //precise equilibrium.  otherwise, refine it.
-	    J = DG;
-	    J += I;
-	    J *= R;
-	    J -= I; 
-	    J.negate();
-	    //J=I-((I+DG)*R);
-	    det = J.adjoint();
-	    ee = A.LNM(z, nothing, det, J, DG, sigma, LNMMax, fuzz,ym1,ym2,ym3);
+	    det = factorJacobian(J, ix, &ixstore[0], I, DG, R);
+	    ee = A.LNM(z, nothing, det, J, ix, DG, sigma, LNMMax, fuzz,ym1,ym2,ym3);
 	  }
 	  if(ee < fuzz) { // only save high quality equilibria;
 	    // this restriction could be removed.
@@ -311,7 +395,10 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 	    Eq[numEq] = new cvector(M);
 	    *(Eq[numEq++]) = sigma;
 
-	    PrintProfile(std::cout, "NE", sigma);
+	    observer->onEquilibrium(sigma);
+	    if (observer->isDone()) {
+	      return numEq;
+	    }
 	  }
 	  Index = -Index;
 	  s_hat_old = -1;
@@ -371,7 +458,7 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 
       // if we've done LNMMax repetitions, time to get back on the path
       if(stepsLeft > 1 && (++k == LNMFreq)) {
-	A.LNM(z, g0, det, J, DG, sigma, LNMMax, fuzz,ym1,ym2,ym3);
+	A.LNM(z, g0, det, J, ix, DG, sigma, LNMMax, fuzz,ym1,ym2,ym3);
 	k = 0;
       }
     } // end of for loop
@@ -396,7 +483,7 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
     A.normalizeStrategy(sigma);
 
     if (g_verbose) {
-      PrintProfile(std::cout, Gambit::lexical_cast<std::string>(lambda), sigma);
+      observer->onPoint(Gambit::lexical_cast<std::string>(lambda), sigma);
     }
 
     z -= ym1;
@@ -416,4 +503,13 @@ int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFr
 
     }
   }
+  return numEq;
+}
+
+int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold, gnmobserver *observer) {
+  return trace(A, g, 0, Eq, steps, fuzz, LNMFreq, LNMMax, LambdaMin, wobble, threshold, observer);
+}
+
+int GNM(gnmgame &A, const cvector &start, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold, gnmobserver *observer) {
+  return trace(A, g, &start, Eq, steps, fuzz, LNMFreq, LNMMax, LambdaMin, wobble, threshold, observer);
 }
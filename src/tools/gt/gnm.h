@@ -23,6 +23,36 @@
 #include "cmatrix.h"
 #include "gnmgame.h"
 
-int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold);
+#include <string>
+
+// gnmobserver receives the output of GNM.  GNM may be run on several
+// perturbation rays at once on different threads, each with its own
+// observer or with one shared between them; in the latter case, the
+// observer must do its own locking.
+class gnmobserver {
+ public:
+  virtual ~gnmobserver() { }
+
+  // called with each equilibrium found
+  virtual void onEquilibrium(const cvector &sigma) = 0;
+
+  // in verbose mode, called with the intermediate points on the path
+  virtual void onPoint(const std::string &label, const cvector &sigma) = 0;
+
+  // GNM abandons the path once this returns true
+  virtual bool isDone() { return false; }
+};
+
+// If no observer is given, the equilibria (and in verbose mode, the
+// intermediate points) are printed to standard output.
+int GNM(gnmgame &A, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold, gnmobserver *observer = 0);
+
+// As above, but the path starts from the profile start, at lambda = 1,
+// instead of far out along the ray.  g is set to a perturbation under
+// which start is an equilibrium; when start is an approximate
+// equilibrium, such as IPA finds, g is small and the path reaches an
+// exact equilibrium after few steps.  Unlike the path from far out,
+// the path through start need not reach an equilibrium at all.
+int GNM(gnmgame &A, const cvector &start, cvector &g, cvector **&Eq, int steps, double fuzz, int LNMFreq, int LNMMax, double LambdaMin, bool wobble, double threshold, gnmobserver *observer = 0);
 
 #endif
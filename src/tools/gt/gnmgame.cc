@@ -23,10 +23,6 @@
 
 gnmgame::gnmgame(int numPlayers, int *actions): numPlayers(numPlayers) {
   int i;
-  numStrategies = 1;
-  for(i = 0; i < numPlayers; i++) {
-    numStrategies *= actions[i];
-  }
 
   this->actions = new int[numPlayers];
   strategyOffset = new int[numPlayers+1];
@@ -117,7 +113,7 @@ void gnmgame::retract(cvector &dest, cvector &z) {
   }
 }
 
-double gnmgame::LNM(cvector &z, const cvector &g, double det, cmatrix &J, cmatrix &DG, cvector &s, int MaxLNM, double fuzz, cvector &del, cvector &scratch, cvector &backup) {
+double gnmgame::LNM(cvector &z, const cvector &g, double det, cmatrix &J, const int *ix, cmatrix &DG, cvector &s, int MaxLNM, double fuzz, cvector &del, cvector &scratch, cvector &backup) {
   double b, e = BIGFLOAT, ee;
   int k, faulted = 0;
   if(MaxLNM >= 1 && det != 0.0) {
@@ -147,8 +143,14 @@ double gnmgame::LNM(cvector &z, const cvector &g, double det, cmatrix &J, cmatri
 	continue;
       }
       e = ee;
-      J.multiply(del, scratch);
-      scratch *= b;
+      if(ix) {
+	scratch = del;
+	J.LUsolve(ix, scratch);
+	scratch *= b * det;
+      } else {
+	J.multiply(del, scratch);
+	scratch *= b;
+      }
       backup = z;
       z -= scratch;
       //      z = z - (J * del) * b;
@@ -36,8 +36,6 @@ class gnmgame {
   // s is of length numPlayers
   virtual double getPurePayoff(int player, int *s) = 0; 
 
-  virtual void setPurePayoff(int player, int *s, double value) = 0;
-
   // The actions of all players are combined in one linear array of length
   // numActions; this gives the index of a player's first action in the array.
   inline int firstAction(int player) {
@@ -67,9 +65,11 @@ class gnmgame {
   // LNM runs the local Newton method on z to attempt to bring it closer to
   // the image of the graph of the equilibrium correspondence above the ray,
   // under the homeomorphism.  In order to prevent costly memory allocation,
-  // a number of scratch vectors are passed in.
+  // a number of scratch vectors are passed in.  If ix is not null, J
+  // holds the LU factors of the Jacobian, with row interchanges ix, as
+  // computed by cmatrix::LUfactor; otherwise J is its adjoint.
 
-  double LNM(cvector &z, const cvector &g, double det, cmatrix &J, cmatrix &DG,  cvector &s, int MaxLNM, double fuzz, cvector &del, cvector &scratch, cvector &backup);
+  double LNM(cvector &z, const cvector &g, double det, cmatrix &J, const int *ix, cmatrix &DG,  cvector &s, int MaxLNM, double fuzz, cvector &del, cvector &scratch, cvector &backup);
 
   // This normalizes a strategy profile by scaling appropriately.
   void normalizeStrategy(cvector &s);
@@ -88,7 +88,7 @@ class gnmgame {
 	    double &D);
 
   int *strategyOffset;
-  int numPlayers, numStrategies, numActions;
+  int numPlayers, numActions;
   int *actions;
   int maxActions;
 };
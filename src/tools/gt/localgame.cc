@@ -0,0 +1,218 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/gt/localgame.cc
+// Games whose payoffs are sums of local terms, for Gametracer
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <algorithm>
+#include "libgambit/libgambit.h"
+#include "gamefile.h"
+#include "localgame.h"
+
+localgame::localgame(int numPlayers, int *actions)
+  : gnmgame(numPlayers, actions), terms(numPlayers)
+{ }
+
+localgame::~localgame()
+{ }
+
+void localgame::addTerm(const std::vector<int> &players, const std::vector<double> &values) {
+  term t;
+  t.players = players;
+  t.values = values;
+  terms[players[0]].push_back(t);
+}
+
+void localgame::addEdge(int player, int other, const std::vector<double> &values) {
+  std::vector<int> players(2);
+  players[0] = player;
+  players[1] = other;
+  addTerm(players, values);
+}
+
+void localgame::normalize() {
+  for(int n = 0; n < numPlayers; n++) {
+    double range = 0.0;
+    for(size_t i = 0; i < terms[n].size(); i++) {
+      std::vector<double> &values = terms[n][i].values;
+      double min = *std::min_element(values.begin(), values.end());
+      double max = *std::max_element(values.begin(), values.end());
+      for(size_t j = 0; j < values.size(); j++)
+	values[j] -= min;
+      range += max - min;
+    }
+    if(range > 0.0) {
+      for(size_t i = 0; i < terms[n].size(); i++) {
+	std::vector<double> &values = terms[n][i].values;
+	for(size_t j = 0; j < values.size(); j++)
+	  values[j] /= range;
+      }
+    }
+  }
+}
+
+double localgame::getPurePayoff(int player, int *s) {
+  double payoff = 0.0;
+  for(size_t i = 0; i < terms[player].size(); i++) {
+    const term &t = terms[player][i];
+    int index = 0, stride = 1;
+    for(size_t j = 0; j < t.players.size(); j++) {
+      index += stride * s[t.players[j]];
+      stride *= actions[t.players[j]];
+    }
+    payoff += t.values[index];
+  }
+  return payoff;
+}
+
+// Contracts the term over the strategies of its players other than
+// its owner and keep (which is -1 to keep only the owner), weighted by
+// s.  dest is indexed by the strategies of the owner and of keep, the
+// owner's varying fastest.
+void localgame::contractTerm(const term &t, int keep, cvector &s, std::vector<double> &dest) {
+  int p = t.players.size(), owner = t.players[0];
+  dest.assign(actions[owner] * ((keep >= 0) ? actions[keep] : 1), 0.0);
+  std::vector<int> idx(p, 0);
+  for(size_t e = 0; e < t.values.size(); e++) {
+    double w = 1.0;
+    int b = 0;
+    for(int i = 1; i < p; i++) {
+      if(t.players[i] == keep)
+	b = idx[i];
+      else
+	w *= s[firstAction(t.players[i]) + idx[i]];
+    }
+    if(w != 0.0)
+      dest[idx[0] + actions[owner] * b] += w * t.values[e];
+    for(int i = 0; i < p; i++) {
+      if(++idx[i] < actions[t.players[i]])
+	break;
+      idx[i] = 0;
+    }
+  }
+}
+
+double localgame::getMixedPayoff(int player, cvector &s) {
+  double payoff = 0.0;
+  std::vector<double> v;
+  for(size_t i = 0; i < terms[player].size(); i++) {
+    contractTerm(terms[player][i], -1, s, v);
+    for(int a = 0; a < actions[player]; a++)
+      payoff += s[firstAction(player) + a] * v[a];
+  }
+  return payoff;
+}
+
+// The block of rows of player n and columns of player m holds the
+// payoffs to n's strategies when m plays each of its strategies.  The
+// terms of n which do not depend on m contribute the same payoff to
+// each column of the block, so the sum base of each term's payoffs is
+// filled in first, and then each term is corrected in the blocks of
+// the players on which it depends.
+void localgame::payoffMatrix(cmatrix &dest, cvector &s, double fuzz) {
+  int n, m, rowi, coli;
+  double fuzzcount;
+  std::vector<double> base, blk;
+  std::vector<std::vector<double> > own;
+  for(n = 0; n < numPlayers; n++) {
+    fuzzcount = fuzz;
+    for(rowi = firstAction(n); rowi < lastAction(n); rowi++) {
+      for(coli = firstAction(n); coli < lastAction(n); coli++) {
+	dest[rowi][coli] = fuzzcount;
+	fuzzcount += fuzz;
+      }
+    }
+
+    base.assign(actions[n], 0.0);
+    own.resize(terms[n].size());
+    for(size_t i = 0; i < terms[n].size(); i++) {
+      contractTerm(terms[n][i], -1, s, own[i]);
+      for(int a = 0; a < actions[n]; a++)
+	base[a] += own[i][a];
+    }
+    for(m = 0; m < numPlayers; m++) {
+      if(m == n)
+	continue;
+      for(rowi = 0; rowi < actions[n]; rowi++) {
+	for(coli = firstAction(m); coli < lastAction(m); coli++) {
+	  dest[firstAction(n)+rowi][coli] = base[rowi];
+	}
+      }
+    }
+
+    for(size_t i = 0; i < terms[n].size(); i++) {
+      const term &t = terms[n][i];
+      for(size_t j = 1; j < t.players.size(); j++) {
+	m = t.players[j];
+	contractTerm(t, m, s, blk);
+	for(rowi = 0; rowi < actions[n]; rowi++) {
+	  for(coli = 0; coli < actions[m]; coli++) {
+	    dest[firstAction(n)+rowi][firstAction(m)+coli] +=
+	      blk[rowi + actions[n] * coli] - own[i][rowi];
+	  }
+	}
+      }
+    }
+  }
+}
+
+localgame *ReadLocalGame(std::istream &p_stream)
+{
+  std::string token;
+  ExpectToken(p_stream, "1");
+  // the title
+  if (!ReadToken(p_stream, token)) {
+    throw Gambit::InvalidFileException();
+  }
+
+  std::vector<int> actions(ReadIntegerList(p_stream));
+  if (actions.empty()) {
+    throw Gambit::InvalidFileException();
+  }
+  localgame *game = new localgame(actions.size(), &actions[0]);
+
+  try {
+    for (p_stream >> std::ws; !p_stream.eof(); p_stream >> std::ws) {
+      std::vector<int> players(ReadIntegerList(p_stream));
+      int size = 1;
+      for (size_t i = 0; i < players.size(); i++) {
+	if (players[i] > (int) actions.size() ||
+	    std::find(players.begin(), players.begin() + i, players[i] - 1) != players.begin() + i) {
+	  throw Gambit::InvalidFileException();
+	}
+	players[i]--;
+	size *= actions[players[i]];
+      }
+      if (players.empty()) {
+	throw Gambit::InvalidFileException();
+      }
+
+      std::vector<double> values(size);
+      for (int i = 0; i < size; i++) {
+	values[i] = ReadPayoff(p_stream);
+      }
+      game->addTerm(players, values);
+    }
+  }
+  catch (...) {
+    delete game;
+    throw;
+  }
+  return game;
+}
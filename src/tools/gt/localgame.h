@@ -0,0 +1,78 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/gt/localgame.h
+// Games whose payoffs are sums of local terms, for Gametracer
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef __LOCALGAME_H
+#define __LOCALGAME_H
+
+#include <iostream>
+#include <vector>
+#include "gnmgame.h"
+#include "cmatrix.h"
+
+// A game in which each player's payoff is the sum of local terms,
+// each of which depends on the strategies of only a few players, as
+// in graphical games.  A polymatrix game is one in which each term
+// depends on the strategies of two players.  Only the terms are
+// stored, so that the game may have far too many strategy profiles
+// for its table of payoffs to be written out, and payoffMatrix costs
+// time in proportion to the size of the terms.
+class localgame : public gnmgame {
+ public:
+  localgame(int numPlayers, int *actions);
+  ~localgame();
+
+  // Adds a term to the payoff of player players[0].  players lists
+  // the distinct players on whose strategies the term depends, with
+  // the owner first; values is indexed by their strategies, with the
+  // first player's varying fastest.
+  void addTerm(const std::vector<int> &players, const std::vector<double> &values);
+
+  // Adds the term of a polymatrix game for the pair of players;
+  // values[a + getNumActions(player) * b] is the payoff to player when
+  // player chooses a and other chooses b.
+  void addEdge(int player, int other, const std::vector<double> &values);
+
+  // Rescales each player's payoffs so they lie between 0 and 1.
+  void normalize();
+
+  double getPurePayoff(int player, int *s);
+  double getMixedPayoff(int player, cvector &s);
+  void payoffMatrix(cmatrix &dest, cvector &s, double fuzz);
+
+ private:
+  struct term {
+    std::vector<int> players;
+    std::vector<double> values;
+  };
+
+  void contractTerm(const term &t, int keep, cvector &s, std::vector<double> &dest);
+
+  // the terms of each player's payoff
+  std::vector<std::vector<term> > terms;
+};
+
+// Reads a game in the local game file format, following its first
+// token LOCAL.  Throws Gambit::InvalidFileException if the file is
+// not in that format.
+localgame *ReadLocalGame(std::istream &p_stream);
+
+#endif
@@ -17,6 +17,7 @@
  * Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
 #include "cmatrix.h"
 #include "nfgame.h"
 
@@ -39,120 +40,127 @@ int nfgame::findIndex(int player, int *s) {
   return retIndex;
 }
 
-double nfgame::getMixedPayoff(int player, cvector &s) {
-  double *m = new double[blockSize[numPlayers]];
-  try {
-    memcpy(m, payoffs.values() + player * blockSize[numPlayers], blockSize[numPlayers]*sizeof(double));
-    double p = localPayoff(s, m, numPlayers);
-    delete [] m;
-    return p;
+// Contracts the payoff array src over the strategies of player
+// dims[d], weighted by that player's probabilities in s, and stores
+// the result in dest, which must not overlap src.  dims lists the
+// players whose strategies index src, the first varying fastest; the
+// contracted player is removed from it.  The innermost loop runs over
+// the contiguous block of the players before dims[d].
+void nfgame::contract(double *dest, const double *src, std::vector<int> &dims, int d, cvector &s) {
+  int i, a, o, inner = 1, outer = 1;
+  for(i = 0; i < d; i++)
+    inner *= actions[dims[i]];
+  for(i = d+1; i < (int) dims.size(); i++)
+    outer *= actions[dims[i]];
+  int n = dims[d], k = actions[n];
+  const double *w = &s[firstAction(n)];
+  if(inner == 1) {
+    for(o = 0; o < outer; o++, src += k) {
+      double sum = 0.0;
+      for(a = 0; a < k; a++)
+	if(w[a] > 0.0)
+	  sum += w[a] * src[a];
+      dest[o] = sum;
+    }
+    dims.erase(dims.begin() + d);
+    return;
   }
-  catch (...) {
-    delete [] m;
-    throw;
+  for(o = 0; o < outer; o++, dest += inner, src += k*inner) {
+    for(i = 0; i < inner; i++)
+      dest[i] = 0.0;
+    for(a = 0; a < k; a++) {
+      if(w[a] > 0.0) {
+	const double *row = src + a*inner;
+	for(i = 0; i < inner; i++)
+	  dest[i] += w[a] * row[i];
+      }
+    }
+  }
+  dims.erase(dims.begin() + d);
+}
+
+// The arrays left after contracting the payoff array of one player
+// over at least one player's strategies
+int nfgame::scratchSize() {
+  int minActions = actions[0];
+  for(int n = 1; n < numPlayers; n++)
+    if(actions[n] < minActions)
+      minActions = actions[n];
+  return blockSize[numPlayers] / minActions;
+}
+
+double nfgame::getMixedPayoff(int player, cvector &s) {
+  std::vector<double> buf1(scratchSize()), buf2(scratchSize());
+  const double *cur = payoffs.values() + player * blockSize[numPlayers];
+  double *next = &buf1[0], *other = &buf2[0];
+  std::vector<int> dims(numPlayers);
+  for(int n = 0; n < numPlayers; n++)
+    dims[n] = n;
+  while(!dims.empty()) {
+    contract(next, cur, dims, dims.size()-1, s);
+    cur = next;
+    std::swap(next, other);
   }
+  return *cur;
 }
 
 void nfgame::payoffMatrix(cmatrix &dest, cvector &s, double fuzz) {
-  int rown, coln, rowi, coli;
+  int rown, coln, rowi, coli, d;
   double fuzzcount;
-  double *m = new double[blockSize[numPlayers]];
-  double *local = new double[maxActions*maxActions];
-  try {
-    for(rown = 0; rown < numPlayers; rown++) {
-      for(coln = 0; coln < numPlayers; coln++) {
-	if(rown == coln) {
-	  fuzzcount = fuzz;
-	  for(rowi=firstAction(rown); rowi < lastAction(rown); rowi++) {
-	    for(coli=firstAction(coln); coli < lastAction(coln); coli++) {
-	      dest[rowi][coli]=fuzzcount;
-	      fuzzcount += fuzz;
-	    }
-	  }
-	} else {
-	  // set m to be the payoffs for player rown
-	  memcpy(m, payoffs.values() + rown * blockSize[numPlayers], blockSize[numPlayers] * sizeof(double));
-	  localPayoffMatrix(local, rown, coln, s, m, numPlayers-1);
-	  for(rowi = firstAction(rown); rowi < lastAction(rown); rowi++) {
-	    for(coli = firstAction(coln); coli < lastAction(coln); coli++) {
-	      if(rown > coln) {
-		dest[rowi][coli] = *(local + (rowi - firstAction(rown))*actions[coln] + (coli - firstAction(coln)));
-	      } else {
-		dest[rowi][coli] = *(local + (coli - firstAction(coln))*actions[rown] + (rowi - firstAction(rown)));
-	      }
-	    }
-	  }
-	}
+  // suffix1 and suffix2 hold in turn the payoffs of player rown,
+  // contracted over the players after coln other than rown; work1
+  // and work2 hold the contractions over the players before coln
+  std::vector<double> suffix1(scratchSize()), suffix2(scratchSize());
+  std::vector<double> work1(scratchSize()), work2(scratchSize());
+  for(rown = 0; rown < numPlayers; rown++) {
+    fuzzcount = fuzz;
+    for(rowi=firstAction(rown); rowi < lastAction(rown); rowi++) {
+      for(coli=firstAction(rown); coli < lastAction(rown); coli++) {
+	dest[rowi][coli]=fuzzcount;
+	fuzzcount += fuzz;
       }
     }
-    delete [] local;
-    delete [] m;
-  }
-  catch (...) {
-    delete [] local;
-    delete [] m;
-    throw;
-  }
-}
 
+    const double *suffix = payoffs.values() + rown * blockSize[numPlayers];
+    double *nextSuffix = &suffix1[0], *otherSuffix = &suffix2[0];
+    std::vector<int> dims(numPlayers);
+    for(int n = 0; n < numPlayers; n++)
+      dims[n] = n;
 
-//assumes m = memcpy(m, payoffs + blockSize[numPlayers] * player1, blockSize[numPlayers]*sizeof(double)), player1 != player2
-//i.e. m points to payoff cmatrix for the desired player
+    for(coln = numPlayers - 1; coln >= 0; coln--) {
+      if(coln == rown)
+	continue;
 
-void nfgame::localPayoffMatrix(double *dest, int player1, int player2, cvector &s, double *m, int n) {
-  int i;
-  if(player1 == n) {
-    for(i = 0; i < actions[player1]; i++) {
-      localPayoffVector(dest+i*actions[player2], player2, s, m+i*blockSize[player1], n-1);
-    }
-  } else if(player2 == n) {
-    for(i = 0; i < actions[player2]; i++) {
-      localPayoffVector(dest+i*actions[player1], player1, s, m+i*blockSize[player2], n-1);
-    }
-  } else {
-    m = scaleMatrix(s, m, n);
-    localPayoffMatrix(dest, player1, player2, s, m, n-1);
-  }
-}
+      // contract the players before coln, other than rown, leaving
+      // the payoffs to rown indexed by the strategies of rown and coln.
+      // As the players are contracted from the last, each player's
+      // position in dims is its own index.
+      std::vector<int> local(dims);
+      const double *cur = suffix;
+      double *next = &work1[0], *other = &work2[0];
+      for(d = coln - 1; d >= 0; d--) {
+	if(d == rown)
+	  continue;
+	contract(next, cur, local, d, s);
+	cur = next;
+	std::swap(next, other);
+      }
 
-double *nfgame::scaleMatrix(cvector &s, double *m, int n) {
-  int i,j, curbase, newbase = -1;
-  double scale;
-  for(i = 0; i < actions[n]; i++) {
-    if(s[i+firstAction(n)] > 0.0) {
-      scale = s[i+firstAction(n)];
-      curbase = i*blockSize[n];
-      if(newbase < 0) {
-	newbase = curbase;
-	for(j = curbase; j < curbase+blockSize[n]; j++) {
-	  m[j] *= scale;
-	}
-      } else {
-	for(j = 0; j < blockSize[n]; j++) {
-	  m[newbase + j] += scale * m[curbase+j];
+      // local is now either (rown, coln) or (coln, rown)
+      int rowstride = (rown < coln) ? 1 : actions[coln];
+      int colstride = (rown < coln) ? actions[rown] : 1;
+      for(rowi = 0; rowi < actions[rown]; rowi++) {
+	for(coli = 0; coli < actions[coln]; coli++) {
+	  dest[firstAction(rown)+rowi][firstAction(coln)+coli] =
+	    cur[rowi*rowstride + coli*colstride];
 	}
       }
-    }
-  }
-  return m+newbase;
-}
 
-void nfgame::localPayoffVector(double *dest, int player, cvector &s, double *m, int n) {
-  if(player == n) {
-    for(int i = 0; i < actions[player]; i++) {
-      dest[i] = localPayoff(s, m+i*blockSize[player], n-1);
+      if(coln > 0) {
+	contract(nextSuffix, suffix, dims, coln, s);
+	suffix = nextSuffix;
+	std::swap(nextSuffix, otherSuffix);
+      }
     }
-  } else {
-    m = scaleMatrix(s, m, n);
-    localPayoffVector(dest, player, s, m, n-1);
-  }
-}
-
-double nfgame::localPayoff(cvector &s, double *m, int n) {
-  if(n < 0)
-    return *m;
-  else {
-    m = scaleMatrix(s, m, n);
-    return localPayoff(s, m, n-1);
   }
 }
@@ -39,15 +39,18 @@ class nfgame : public gnmgame {
   }
 
   double getMixedPayoff(int player, cvector &s);
+
+  // For each player, the payoff array is contracted over the other
+  // players' strategies once, from the last player down; the partial
+  // products so obtained are shared by all the blocks of that
+  // player's rows, rather than each block contracting the whole array.
   void payoffMatrix(cmatrix &dest, cvector &s, double fuzz);
 
 
  private:
   int findIndex(int player, int *s);
-  void localPayoffMatrix(double *dest, int player1, int player2, cvector &s, double *m, int n);
-  void localPayoffVector(double *dest, int player, cvector &s, double *m, int n);
-  double localPayoff(cvector &s, double *m, int n);
-  double *scaleMatrix(cvector &s, double *m, int n);
+  int scratchSize();
+  void contract(double *dest, const double *src, std::vector<int> &dims, int d, cvector &s);
   cvector payoffs;
   int *blockSize;
 };
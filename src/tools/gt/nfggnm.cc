@@ -26,11 +26,17 @@
 #include <iostream>
 #include <fstream>
 #include <cerrno>
+#include <vector>
+#include <iterator>
+#include <sstream>
 #include "libgambit/libgambit.h"
+#include "libgambit/threads.h"
 
 #include "nfgame.h"
+#include "gamefile.h"
 #include "gnmgame.h"
 #include "gnm.h"
+#include "ipa.h"
 
 // GNM CONSTANTS
 const int STEPS = 100;
@@ -41,9 +47,19 @@ const double LAMBDAMIN = -10.0;
 const bool WOBBLE = false;
 const double THRESHOLD = 1e-2;
 
+// equilibria closer than this in every coordinate are reported once
+const double DISTINCT = 1e-6;
+
+// IPA CONSTANTS, for finding starting points
+const double ALPHA = 0.02;
+const double EQERR = 1e-6;
+
 int g_numDecimals = 6;
 bool g_verbose = false;
 int g_numVectors = 1;
+int g_stopAfter = 0;
+int g_numThreads = 1;
+bool g_ipaStart = false;
 std::string g_startFile;
 
 bool ReadProfile(std::istream &p_stream, cvector &p_profile)
@@ -85,9 +101,12 @@ void PrintHelp(char *progname)
 
   std::cerr << "Options:\n";
   std::cerr << "  -d DECIMALS      show equilibria as floating point with DECIMALS digits\n";
+  std::cerr << "  -e EQA           terminate after finding EQA distinct equilibria\n";
   std::cerr << "  -h, --help       print this help message\n";
+  std::cerr << "  -i               start each path from an approximate equilibrium found by IPA\n";
   std::cerr << "  -n COUNT         number of perturbation vectors to generate\n";
   std::cerr << "  -s FILE          file containing perturbation vectors\n";
+  std::cerr << "  -t THREADS       number of threads used to trace the vectors\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -V, --verbose    verbose mode (shows intermediate output)\n";
   std::cerr << "  -v, --version    print version information\n";
@@ -95,63 +114,146 @@ void PrintHelp(char *progname)
   exit(1);
 }
 
-void Solve(const Gambit::Game &p_game)
-{
-  int i;
+//
+// The equilibria found along all the perturbation rays.  Each is
+// printed when first found; equilibria which are found again, from
+// the same ray or from another, are not repeated.  When the rays are
+// traced on several threads, the threads share one set, and the order
+// in which the equilibria are printed may vary from run to run.
+//
+class EquilibriumSet : public gnmobserver {
+private:
+  Gambit::Mutex m_mutex;
+  std::vector<cvector> m_equilibria;
+  int m_stopAfter;
 
-  Gambit::Rational maxPay = p_game->GetMaxPayoff();
-  Gambit::Rational minPay = p_game->GetMinPayoff();
-  double scale = 1.0 / (maxPay - minPay);
+public:
+  EquilibriumSet(int p_stopAfter) : m_stopAfter(p_stopAfter) { }
+  virtual ~EquilibriumSet() { }
 
-  int *actions = new int[p_game->NumPlayers()];
-  int veclength = p_game->NumPlayers();
-  for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-    actions[pl-1] = p_game->GetPlayer(pl)->NumStrategies();
-    veclength *= p_game->GetPlayer(pl)->NumStrategies();
+  void onEquilibrium(const cvector &sigma);
+  void onPoint(const std::string &label, const cvector &sigma);
+  bool isDone(void);
+};
+
+void EquilibriumSet::onEquilibrium(const cvector &sigma)
+{
+  Gambit::MutexLock lock(m_mutex);
+  if (m_stopAfter > 0 && (int) m_equilibria.size() >= m_stopAfter) {
+    return;
   }
-  cvector payoffs(veclength);
-  
-  gnmgame *A = new nfgame(p_game->NumPlayers(), actions, payoffs);
-  
-  int *profile = new int[p_game->NumPlayers()];
-  for (Gambit::StrategyIterator iter(p_game); !iter.AtEnd(); iter++) {
-    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-      profile[pl-1] = (*iter)->GetStrategy(pl)->GetNumber() - 1;
+  for (size_t eq = 0; eq < m_equilibria.size(); eq++) {
+    const cvector &other = m_equilibria[eq];
+    int i = 0;
+    while (i < sigma.getm() && fabs(sigma[i] - other[i]) < DISTINCT) {
+      i++;
+    }
+    if (i == sigma.getm()) {
+      return;
     }
+  }
+  m_equilibria.push_back(sigma);
+  PrintProfile(std::cout, "NE", sigma);
+}
 
-    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-      A->setPurePayoff(pl-1, profile, 
-		       (double) ((*iter)->GetPayoff(pl) - minPay) *
-		       scale);
+void EquilibriumSet::onPoint(const std::string &label, const cvector &sigma)
+{
+  Gambit::MutexLock lock(m_mutex);
+  PrintProfile(std::cout, label, sigma);
+}
+
+bool EquilibriumSet::isDone(void)
+{
+  Gambit::MutexLock lock(m_mutex);
+  return (m_stopAfter > 0 && (int) m_equilibria.size() >= m_stopAfter);
+}
+
+//
+// Traces the perturbation rays in turn; when run on several threads,
+// each thread takes the next ray not yet started, and follows it with
+// its own copy of the ray and its own scratch matrices in GNM.
+//
+class RayTask : public Gambit::ThreadTask {
+private:
+  gnmgame &m_game;
+  const std::vector<cvector> &m_rays;
+  EquilibriumSet &m_equilibria;
+  Gambit::Mutex m_mutex;
+  size_t m_next;
+
+public:
+  RayTask(gnmgame &p_game, const std::vector<cvector> &p_rays,
+	  EquilibriumSet &p_equilibria)
+    : m_game(p_game), m_rays(p_rays), m_equilibria(p_equilibria), m_next(0)
+  { }
+  virtual ~RayTask() { }
+
+  void Run(void);
+};
+
+void RayTask::Run(void)
+{
+  while (!m_equilibria.isDone()) {
+    size_t ray;
+    {
+      Gambit::MutexLock lock(m_mutex);
+      if (m_next >= m_rays.size()) {
+	return;
+      }
+      ray = m_next++;
+    }
+
+    cvector g(m_rays[ray]);
+    if (g_verbose) {
+      m_equilibria.onPoint("pert", g);
+    }
+
+    cvector **answers;
+    int numEq;
+    if (g_ipaStart) {
+      // IPA, run along the same ray, finds an approximate equilibrium
+      // quickly; GNM then follows the path from it to an exact one
+      cvector zh(m_game.getNumActions(), 1.0), start(m_game.getNumActions());
+      IPA(m_game, g, zh, ALPHA, EQERR, start);
+      if (g_verbose) {
+	m_equilibria.onPoint("ipa", start);
+      }
+      numEq = GNM(m_game, start, g, answers, STEPS, FUZZ, LNMFREQ, LNMMAX,
+		  LAMBDAMIN, WOBBLE, THRESHOLD, &m_equilibria);
     }
+    else {
+      numEq = GNM(m_game, g, answers, STEPS, FUZZ, LNMFREQ, LNMMAX,
+		  LAMBDAMIN, WOBBLE, THRESHOLD, &m_equilibria);
+    }
+    for (int i = 0; i < numEq; i++) {
+      delete answers[i];
+    }
+    free(answers);
   }
+}
 
-  cvector g(A->getNumActions()); // choose a random perturbation ray
-  int numEq;
+void Solve(gnmgame &A)
+{
+  int i;
+
+  // The rays are all read or generated before any is traced, so that
+  // each ray is the same whatever the number of threads
+  std::vector<cvector> rays;
+  cvector g(A.getNumActions()); // choose a random perturbation ray
 
   if (g_startFile != "") {
     std::ifstream startVectors(g_startFile.c_str());
 
     while (!startVectors.eof() && !startVectors.bad()) {
-      cvector **answers;
       if (ReadProfile(startVectors, g)) {
 	g /= g.norm(); // normalized
-	if (g_verbose) {
-	  PrintProfile(std::cout, "pert", g);
-	}
-
-	numEq = GNM(*A, g, answers, STEPS, FUZZ, LNMFREQ, LNMMAX, LAMBDAMIN, WOBBLE, THRESHOLD);
-	for (i = 0; i < numEq; i++) {
-	  free(answers[i]);
-	}
-	free(answers);
+	rays.push_back(g);
       }
     }
   }
   else {
     for (int iter = 0; iter < g_numVectors; iter++) {
-      cvector **answers;
-      for(i = 0; i < A->getNumActions(); i++) {
+      for(i = 0; i < A.getNumActions(); i++) {
 #if !defined(HAVE_DRAND48)
 	g[i] = rand();
 #else
@@ -159,17 +261,53 @@ void Solve(const Gambit::Game &p_game)
 #endif  // HAVE_DRAND48
       }
       g /= g.norm(); // normalized
-      if (g_verbose) {
-	PrintProfile(std::cout, "pert", g);
-      }
-      numEq = GNM(*A, g, answers, STEPS, FUZZ, LNMFREQ, LNMMAX, LAMBDAMIN, WOBBLE, THRESHOLD);
-      for (i = 0; i < numEq; i++) {
-	free(answers[i]);
-      }
-      free(answers);
+      rays.push_back(g);
     }
   }
 
+  EquilibriumSet equilibria(g_stopAfter);
+  RayTask task(A, rays, equilibria);
+  if (g_numThreads > 1) {
+    Gambit::RunThreads(task, g_numThreads);
+  }
+  else {
+    task.Run();
+  }
+}
+
+void Solve(const Gambit::Game &p_game)
+{
+  Gambit::Rational maxPay = p_game->GetMaxPayoff();
+  Gambit::Rational minPay = p_game->GetMinPayoff();
+  double scale = 1.0 / (maxPay - minPay);
+
+  int *actions = new int[p_game->NumPlayers()];
+  int veclength = p_game->NumPlayers();
+  for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+    actions[pl-1] = p_game->GetPlayer(pl)->NumStrategies();
+    veclength *= p_game->GetPlayer(pl)->NumStrategies();
+  }
+  cvector payoffs(veclength);
+  
+  nfgame *A = new nfgame(p_game->NumPlayers(), actions, payoffs);
+  
+  int *profile = new int[p_game->NumPlayers()];
+  for (Gambit::StrategyIterator iter(p_game); !iter.AtEnd(); iter++) {
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      profile[pl-1] = (*iter)->GetStrategy(pl)->GetNumber() - 1;
+    }
+
+    for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
+      A->setPurePayoff(pl-1, profile, 
+		       (double) ((*iter)->GetPayoff(pl) - minPay) *
+		       scale);
+    }
+  }
+
+  Solve(*A);
+
+  delete [] profile;
+  delete [] actions;
   delete A;
 }
 
@@ -186,7 +324,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:n:s:qvVhS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:e:in:s:t:qvVhS", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -199,12 +337,24 @@ int main(int argc, char *argv[])
     case 'd':
       g_numDecimals = atoi(optarg);
       break;
+    case 'e':
+      g_stopAfter = atoi(optarg);
+      break;
+    case 'i':
+      g_ipaStart = true;
+      break;
     case 'n':
       g_numVectors = atoi(optarg);
       break;
     case 's':
       g_startFile = optarg;
       break;
+    case 't':
+      g_numThreads = atoi(optarg);
+      if (g_numThreads <= 0) {
+	g_numThreads = Gambit::NumProcessors();
+      }
+      break;
     case 'S':
       break;
     case 'h':
@@ -241,8 +391,20 @@ int main(int argc, char *argv[])
   }
 
   try {
-    Gambit::Game game = Gambit::ReadGame(*input_stream);
-    Solve(game);
+    // Games in the local and action-graph game formats, which Gambit
+    // does not read, are recognized by their first token
+    std::string text((std::istreambuf_iterator<char>(*input_stream)),
+		     std::istreambuf_iterator<char>());
+    std::istringstream stream(text);
+    if (IsGametracerFile(text)) {
+      gnmgame *game = ReadGametracerGame(stream, true);
+      Solve(*game);
+      delete game;
+    }
+    else {
+      Gambit::Game game = Gambit::ReadGame(stream);
+      Solve(game);
+    }
     return 0;
   }
   catch (Gambit::InvalidFileException) {
@@ -26,9 +26,12 @@
 #include <iostream>
 #include <fstream>
 #include <cerrno>
+#include <iterator>
+#include <sstream>
 #include "libgambit/libgambit.h"
 
 #include "nfgame.h"
+#include "gamefile.h"
 #include "ipa.h"
 
 #define ALPHA 0.02
@@ -36,13 +39,12 @@
 
 int g_numDecimals = 6;
 
-void PrintProfile(std::ostream &p_stream,
-		  const Gambit::Game &p_game, cvector *p_profile)
+void PrintProfile(std::ostream &p_stream, const cvector &p_profile)
 {
   p_stream.setf(std::ios::fixed);
   p_stream << "NE";
-  for (int i = 0; i < p_game->MixedProfileLength(); i++) {
-    p_stream << "," << std::setprecision(g_numDecimals) << (*p_profile)[i];
+  for (int i = 0; i < p_profile.getm(); i++) {
+    p_stream << "," << std::setprecision(g_numDecimals) << p_profile[i];
   }
   p_stream << std::endl;
 }
@@ -69,10 +71,28 @@ void PrintHelp(char *progname)
   exit(1);
 }
 
-void Solve(const Gambit::Game &p_game, const Gambit::Array<double> &p_pert)
+// Traces the path along the perturbation ray of all ones.
+void Solve(gnmgame &A)
 {
   int i;
+  cvector g(A.getNumActions()); // perturbation ray
+  int numEq;
+
+  cvector ans(A.getNumActions());
+  cvector zh(A.getNumActions(),1.0);
+  do {
+    for(i = 0; i < A.getNumActions(); i++) {
+      g[i] = 1.0;
+    }
+    g /= g.norm(); // normalized
+    numEq = IPA(A, g, zh, ALPHA, EQERR, ans);
+  } while(numEq == 0);
+
+  PrintProfile(std::cout, ans);
+}
 
+void Solve(const Gambit::Game &p_game)
+{
   int *actions = new int[p_game->NumPlayers()];
   int veclength = p_game->NumPlayers();
   for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
@@ -81,7 +101,7 @@ void Solve(const Gambit::Game &p_game, const Gambit::Array<double> &p_pert)
   }
   cvector payoffs(veclength);
   
-  gnmgame *A = new nfgame(p_game->NumPlayers(), actions, payoffs);
+  nfgame *A = new nfgame(p_game->NumPlayers(), actions, payoffs);
   
   int *profile = new int[p_game->NumPlayers()];
   for (Gambit::StrategyIterator iter(p_game); !iter.AtEnd(); iter++) {
@@ -94,22 +114,10 @@ void Solve(const Gambit::Game &p_game, const Gambit::Array<double> &p_pert)
     }
   }
 
-  cvector g(A->getNumActions()); // perturbation ray
-  int numEq;
-
-  cvector ans(A->getNumActions());
-  cvector zh(A->getNumActions(),1.0);
-  do {
-    for(i = 0; i < A->getNumActions(); i++) {
-      g[i] = p_pert[i+1];
-    }
-    g /= g.norm(); // normalized
-    numEq = IPA(*A, g, zh, ALPHA, EQERR, ans);
-  } while(numEq == 0);
-
-
-  PrintProfile(std::cout, p_game, &ans);
+  Solve(*A);
 
+  delete [] profile;
+  delete [] actions;
   delete A;
 }
 
@@ -172,14 +180,20 @@ int main(int argc, char *argv[])
   }
 
   try {
-    Gambit::Game game = Gambit::ReadGame(*input_stream);
-
-    Gambit::Array<double> pert(game->MixedProfileLength());
-    for (int i = 1; i <= pert.Length(); i++) {
-      pert[i] = 1.0;
+    // Games in the local and action-graph game formats, which Gambit
+    // does not read, are recognized by their first token
+    std::string text((std::istreambuf_iterator<char>(*input_stream)),
+		     std::istreambuf_iterator<char>());
+    std::istringstream stream(text);
+    if (IsGametracerFile(text)) {
+      gnmgame *game = ReadGametracerGame(stream, false);
+      Solve(*game);
+      delete game;
+    }
+    else {
+      Gambit::Game game = Gambit::ReadGame(stream);
+      Solve(game);
     }
-
-    Solve(game, pert);
     return 0;
   }
   catch (Gambit::InvalidFileException) {
@@ -25,6 +25,7 @@
 #include <unistd.h>
 #include <iostream>
 #include "libgambit/libgambit.h"
+#include "libgambit/threads.h"
 
 using namespace Gambit;
 
@@ -34,7 +35,9 @@ using namespace Gambit;
 extern int g_numDecimals;
 extern int g_stopAfter;
 extern int g_maxDepth;
+extern int g_numThreads;
 extern bool g_printDetail;
+extern bool g_hybrid;
 
 namespace {
 //
@@ -153,19 +156,164 @@ void PrintProfileDetail(std::ostream &p_stream,
   }
 }
 
+//
+// Returns the basic variables of the tableau, with their values
+//
+template <class T> BFS<T> TableauBFS(const LTableau<T> &p_tableau)
+{
+  BFS<T> cbfs;
+  Vector<T> v(p_tableau.MinRow(), p_tableau.MaxRow());
+  p_tableau.BasisVector(v);
+
+  for (int i = p_tableau.MinCol(); i <= p_tableau.MaxCol(); i++) {
+    if (p_tableau.Member(i)) {
+      cbfs.insert(i, v[p_tableau.Find(i)]);
+    }
+  }
+  return cbfs;
+}
+
+//
+// Follows the paths leaving one equilibrium, for the parallel version
+// of AllLemke.  The paths are handed out to the threads in order.  The
+// covering vector is perturbed differently for each path, so each
+// thread works on its own copy of the matrix.  As in the serial search,
+// the result is the first path in order which reaches an equilibrium
+// not already known; later paths are abandoned once one is found.
+//
+template <class T> class LemkeLevelTask : public ThreadTask {
+private:
+  const LTableau<T> &m_tableau;
+  const SparseMatrix<T> &m_A;
+  const BFSList<T> &m_known;
+  int m_dup, m_depth;
+  Mutex m_mutex;
+  int m_next, m_found;
+  LTableau<T> *m_result;
+
+  void FollowPaths(LTableau<T> &p_base, SparseMatrix<T> &p_A);
+
+public:
+  LemkeLevelTask(const LTableau<T> &p_tableau, const SparseMatrix<T> &p_A,
+		 const BFSList<T> &p_known, int p_dup, int p_depth)
+    : m_tableau(p_tableau), m_A(p_A), m_known(p_known),
+      m_dup(p_dup), m_depth(p_depth), 
+      m_next(p_tableau.MinRow()), m_found(0), m_result(0) { }
+  virtual ~LemkeLevelTask() { if (m_result) delete m_result; }
+
+  void Run(void);
+
+  // The path reaching the new equilibrium, or zero if there is none
+  int GetFound(void) const { return m_found; }
+  // Passes ownership of the tableau at the new equilibrium to the
+  // caller.  The tableau must be pointed at the original matrix with
+  // Set_A() and refactored before use.
+  LTableau<T> *TakeResult(void) 
+  { LTableau<T> *result = m_result; m_result = 0; return result; }
+};
+
+template <class T> void LemkeLevelTask<T>::Run(void)
+{
+  SparseMatrix<T> A(m_A);
+  LTableau<T> *base;
+  {
+    // Refactoring the copy detaches it from the original tableau
+    MutexLock lock(m_mutex);
+    base = new LTableau<T>(m_tableau);
+    base->Set_A(A);
+    base->Refactor();
+  }
+  try {
+    FollowPaths(*base, A);
+  }
+  catch (...) {
+    delete base;
+    throw;
+  }
+  delete base;
+}
+
+template <class T> 
+void LemkeLevelTask<T>::FollowPaths(LTableau<T> &p_base, SparseMatrix<T> &p_A)
+{
+  T small_num = (T)1/(T)1000;
+
+  while (true) {
+    int i;
+    {
+      MutexLock lock(m_mutex);
+      if (m_next == m_dup) {
+	m_next++;
+      }
+      i = m_next++;
+      if (i > m_tableau.MaxRow() || (m_found > 0 && i > m_found)) {
+	return;
+      }
+    }
+
+    LTableau<T> tab(p_base);
+    p_A(i,0) = -small_num;
+    tab.Refactor();
+
+    int missing;
+    if (m_depth == 0) {
+      tab.Pivot(m_dup, 0);
+      missing = -m_dup;
+    }
+    else {
+      missing = tab.SF_PivotIn(0);
+    }
+    bool reached = (tab.SF_LCPPath(-missing) == 1);
+    p_A(i,0) = (T) -1;
+    if (!reached) {
+      continue;
+    }
+
+    BFS<T> cbfs(TableauBFS(tab));
+    {
+      MutexLock lock(m_mutex);
+      if (m_known.Contains(cbfs) || (m_found > 0 && i > m_found)) {
+	continue;
+      }
+    }
+
+    LTableau<T> *result = new LTableau<T>(tab);
+    result->Refactor();
+    MutexLock lock(m_mutex);
+    if (m_found == 0 || i < m_found) {
+      if (m_result) {
+	delete m_result;
+      }
+      m_result = result;
+      m_found = i;
+    }
+    else {
+      delete result;
+    }
+  }
+}
+
 template <class T> class SolveEfgLcp {
 private:
   int ns1,ns2,ni1,ni2;
   T maxpay,eps;
-  List<BFS<T> > m_list;
+  BFSList<T> m_list;
   List<GameInfoset> isets1, isets2;
 
-  void FillTableau(const BehavSupport &, Matrix<T> &, const GameNode &, T,
+  void FillTableau(const BehavSupport &, SparseMatrix<T> &, const GameNode &, T,
 		   int, int, int, int);
   int AddBFS(const LTableau<T> &tab);
   int AllLemke(const BehavSupport &, int dup, LTableau<T> &B,
-	       int depth, Matrix<T> &,
+	       int depth, SparseMatrix<T> &,
 	       bool p_print, List<MixedBehavProfile<T> > &);
+  void AllLemkeParallel(const BehavSupport &, int dup, LTableau<T> &B,
+			int depth, SparseMatrix<T> &,
+			bool p_print, List<MixedBehavProfile<T> > &);
+  bool CertifyBasis(const LTableau<double> &, LTableau<T> &);
+  int AllLemkeHybrid(const BehavSupport &, int dup, 
+		     LTableau<double> &F, SparseMatrix<double> &, 
+		     LTableau<T> &B, SparseMatrix<T> &, int depth,
+		     bool p_print, List<MixedBehavProfile<T> > &);
   
   void GetProfile(const BehavSupport &, const LTableau<T> &tab, 
 		  MixedBehavProfile<T> &, const Vector<T> &, 
@@ -227,12 +375,12 @@ template <class T> List<MixedBehavProfile<T> >
 SolveEfgLcp<T>::Solve(const BehavSupport &p_support, bool p_print /*= true*/)
 {
   BFS<T> cbfs;
-  int i, j;
+  int i;
 
   isets1 = p_support.ReachableInfosets(p_support.GetGame()->GetPlayer(1));
   isets2 = p_support.ReachableInfosets(p_support.GetGame()->GetPlayer(2));
 
-  m_list = List<BFS<T> >();
+  m_list = BFSList<T>();
 
   int ntot;
   ns1 = p_support.NumSequences(1);
@@ -242,18 +390,13 @@ SolveEfgLcp<T>::Solve(const BehavSupport &p_support, bool p_print /*= true*/)
 
   ntot = ns1+ns2+ni1+ni2;
 
-  Matrix<T> A(1,ntot,0,ntot);
+  SparseMatrix<T> A(1,ntot,0,ntot);
   Vector<T> b(1,ntot);
 
   maxpay = p_support.GetGame()->GetMaxPayoff() + Rational(1);
 
   T prob = (T)1;
-  for (i = A.MinRow(); i <= A.MaxRow(); i++) {
-    b[i] = (T) 0;
-    for (j = A.MinCol(); j <= A.MaxCol(); j++) {
-      A(i,j) = (T) 0; 
-    }
-  }
+  b = (T) 0;
 
   FillTableau(p_support, A, p_support.GetGame()->GetRoot(), prob, 1, 1, 0, 0);
   for (i = A.MinRow(); i <= A.MaxRow(); i++) { 
@@ -274,9 +417,55 @@ SolveEfgLcp<T>::Solve(const BehavSupport &p_support, bool p_print /*= true*/)
   List<MixedBehavProfile<T> > solutions;
   
   try {
+    if (g_hybrid) {
+      SparseMatrix<double> fA(A.MinRow(), A.MaxRow(), A.MinCol(), A.MaxCol());
+      for (int j = A.MinCol(); j <= A.MaxCol(); j++) {
+	for (typename SparseMatrix<T>::const_iterator entry = A.Begin(j);
+	     entry != A.End(j); entry++) {
+	  fA(entry->first, j) = (double) entry->second;
+	}
+      }
+      Vector<double> fb(b.First(), b.Last());
+      for (i = b.First(); i <= b.Last(); i++) {
+	fb[i] = (double) b[i];
+      }
+      LTableau<double> ftab(fA, fb);
+
+      if (g_stopAfter != 1) {
+	try {
+	  AllLemkeHybrid(p_support, ns1+ns2+1, ftab, fA, tab, A, 0,
+			 p_print, solutions);
+	}
+	catch (EquilibriumLimitReachedEfg &) { }
+	return solutions;
+      }
+
+      ftab.Pivot(ns1+ns2+1, 0);
+      ftab.SF_LCPPath(ns1+ns2+1);
+      if (!CertifyBasis(ftab, tab)) {
+	tab.Pivot(ns1+ns2+1, 0);
+	tab.SF_LCPPath(ns1+ns2+1);
+      }
+      AddBFS(tab);
+      tab.BasisVector(sol);
+      GetProfile(p_support, tab, 
+		 profile,sol,p_support.GetGame()->GetRoot(),1,1);
+      UndefinedToCentroid(profile);
+      PrintProfile(std::cout, "NE", profile);
+      if (g_printDetail) {
+	PrintProfileDetail(std::cout, profile);
+      }
+      return solutions;
+    }
+
     if (g_stopAfter != 1) {
       try {
-	AllLemke(p_support, ns1+ns2+1, tab, 0, A, p_print, solutions);
+	if (g_numThreads > 1) {
+	  AllLemkeParallel(p_support, ns1+ns2+1, tab, 0, A, p_print, solutions);
+	}
+	else {
+	  AllLemke(p_support, ns1+ns2+1, tab, 0, A, p_print, solutions);
+	}
       }
       catch (EquilibriumLimitReachedEfg &) {
 	// Just handle this silently; equilibria are already printed
@@ -308,15 +497,7 @@ SolveEfgLcp<T>::Solve(const BehavSupport &p_support, bool p_print /*= true*/)
 
 template <class T> int SolveEfgLcp<T>::AddBFS(const LTableau<T> &tableau)
 {
-  BFS<T> cbfs;
-  Vector<T> v(tableau.MinRow(), tableau.MaxRow());
-  tableau.BasisVector(v);
-
-  for (int i = tableau.MinCol(); i <= tableau.MaxCol(); i++) {
-    if (tableau.Member(i)) {
-      cbfs.insert(i, v[tableau.Find(i)]);
-    }
-  }
+  BFS<T> cbfs(TableauBFS(tableau));
 
   if (m_list.Contains(cbfs))  return 0;
   m_list.Append(cbfs);
@@ -333,7 +514,7 @@ template <class T> int SolveEfgLcp<T>::AddBFS(const LTableau<T> &tableau)
 template <class T> int 
 SolveEfgLcp<T>::AllLemke(const BehavSupport &p_support,
 			 int j, LTableau<T> &B, int depth,
-			 Matrix<T> &A,
+			 SparseMatrix<T> &A,
 			 bool p_print,
 			 List<MixedBehavProfile<T> > &p_solutions)
 {
@@ -398,8 +579,204 @@ SolveEfgLcp<T>::AllLemke(const BehavSupport &p_support,
   return 1;
 }
 
+//
+// In hybrid mode, the paths are followed in floating point.  At the end
+// of each, the exact tableau at the start of the path is pivoted to the
+// basis reached, and the equilibrium is accepted if that basis is
+// nonsingular and feasible in exact arithmetic.  Otherwise, the path is
+// followed again exactly, and the floating-point tableau is moved to the
+// basis reached there, so the equilibria found are exactly those of
+// AllLemke in exact arithmetic.
+//
+template <class T> bool
+SolveEfgLcp<T>::CertifyBasis(const LTableau<double> &p_float,
+			     LTableau<T> &p_exact)
+{
+  Array<int> labels;
+  for (int i = p_float.MinRow(); i <= p_float.MaxRow(); i++) {
+    labels.Append(p_float.Label(i));
+  }
+  if (labels.Contains(0)) {
+    // the path did not reach an equilibrium
+    return false;
+  }
+
+  LTableau<T> start(p_exact);
+  try {
+    PivotToBasis(p_exact, labels);
+    Vector<T> sol(p_exact.MinRow(), p_exact.MaxRow());
+    p_exact.BasisVector(sol);
+    for (int i = sol.First(); i <= sol.Last(); i++) {
+      if (sol[i] < (T) 0) {
+	p_exact = start;
+	return false;
+      }
+    }
+    return true;
+  }
+  catch (Exception &) {
+    // the basis is singular in exact arithmetic
+    p_exact = start;
+    return false;
+  }
+}
+
+template <class T> int 
+SolveEfgLcp<T>::AllLemkeHybrid(const BehavSupport &p_support, int j,
+			       LTableau<double> &F, SparseMatrix<double> &fA,
+			       LTableau<T> &B, SparseMatrix<T> &A, int depth,
+			       bool p_print,
+			       List<MixedBehavProfile<T> > &p_solutions)
+{
+  if (g_maxDepth != 0 && depth > g_maxDepth) {
+    return 1;
+  }
+
+  int i,newsol,missing;
+  T small_num = (T)1/(T)1000;
+
+  Vector<T> sol(B.MinRow(),B.MaxRow());
+  MixedBehavProfile<T> profile(p_support);
+
+  newsol =0;
+  for (i = B.MinRow(); i <= B.MaxRow() && newsol == 0; i++) {
+    if (i != j)  {
+      LTableau<double> FCopy(F);
+      fA(i,0) = -0.001;
+      FCopy.Refactor();
+      if (depth == 0) {
+	FCopy.Pivot(j, 0);
+	missing = -j;
+      }
+      else {
+	missing = FCopy.SF_PivotIn(0);
+      }
+      bool reached = (FCopy.SF_LCPPath(-missing) == 1);
+      fA(i,0) = -1.0;
+
+      if (reached) {
+	// An equilibrium already found has been certified, and need not be
+	// again; BFS's are compared by their bases only
+	BFS<T> cbfs;
+	for (int k = FCopy.MinCol(); k <= FCopy.MaxCol(); k++) {
+	  if (FCopy.Member(k))  cbfs.insert(k, (T) 0);
+	}
+	if (m_list.Contains(cbfs))  continue;
+      }
+
+      LTableau<T> BCopy(B);
+      if (!reached || !CertifyBasis(FCopy, BCopy)) {
+	A(i,0) = -small_num;
+	BCopy.Refactor();
+	if (depth == 0) {
+	  BCopy.Pivot(j, 0);
+	  missing = -j;
+	}
+	else {
+	  missing = BCopy.SF_PivotIn(0);
+	}
+	reached = (BCopy.SF_LCPPath(-missing) == 1);
+	A(i,0) = (T) -1;
+	if (reached) {
+	  BCopy.Refactor();
+	  Array<int> labels;
+	  for (int k = BCopy.MinRow(); k <= BCopy.MaxRow(); k++) {
+	    labels.Append(BCopy.Label(k));
+	  }
+	  PivotToBasis(FCopy, labels);
+	}
+      }
+
+      newsol = 0;
+      if (reached) {
+	newsol = AddBFS(BCopy);
+	BCopy.BasisVector(sol);
+	GetProfile(p_support, BCopy, profile, sol,
+		   p_support.GetGame()->GetRoot(), 1, 1);
+	UndefinedToCentroid(profile);
+	if (newsol) {
+	  if (p_print) {
+	    PrintProfile(std::cout, "NE", profile);
+	    if (g_printDetail) {
+	      PrintProfileDetail(std::cout, profile);
+	    }
+	  }
+	  p_solutions.Append(profile);
+	  if (g_stopAfter > 0 && p_solutions.Length() >= g_stopAfter) {
+	    throw EquilibriumLimitReachedEfg();
+	  }
+	}
+      }
+      
+      if (newsol) {
+	FCopy.Refactor();
+	AllLemkeHybrid(p_support, i, FCopy, fA, BCopy, A, depth+1, 
+		       p_print, p_solutions);
+      }
+    }
+  }
+  
+  return 1;
+}
+
+//
+// The parallel version of AllLemke.  The paths from each equilibrium
+// are followed concurrently, and the search continues from the first
+// of these, in order, to reach a new equilibrium, so the equilibria
+// found are the same as for AllLemke.
+//
+template <class T> void
+SolveEfgLcp<T>::AllLemkeParallel(const BehavSupport &p_support,
+				 int j, LTableau<T> &B, int depth,
+				 SparseMatrix<T> &A,
+				 bool p_print,
+				 List<MixedBehavProfile<T> > &p_solutions)
+{
+  if (g_maxDepth != 0 && depth > g_maxDepth) {
+    return;
+  }
+
+  LemkeLevelTask<T> task(B, A, m_list, j, depth);
+  RunThreads(task, g_numThreads);
+  LTableau<T> *next = task.TakeResult();
+  if (!next) {
+    return;
+  }
+
+  try {
+    next->Set_A(A);
+    next->Refactor();
+    AddBFS(*next);
+
+    Vector<T> sol(next->MinRow(), next->MaxRow());
+    MixedBehavProfile<T> profile(p_support);
+    next->BasisVector(sol);
+    GetProfile(p_support, *next, profile, sol,
+	       p_support.GetGame()->GetRoot(), 1, 1);
+    UndefinedToCentroid(profile);
+    if (p_print) {
+      PrintProfile(std::cout, "NE", profile);
+      if (g_printDetail) {
+	PrintProfileDetail(std::cout, profile);
+      }
+    }
+    p_solutions.Append(profile);
+    if (g_stopAfter > 0 && p_solutions.Length() >= g_stopAfter) {
+      throw EquilibriumLimitReachedEfg();
+    }
+
+    AllLemkeParallel(p_support, task.GetFound(), *next, depth+1, 
+		     A, p_print, p_solutions);
+  }
+  catch (...) {
+    delete next;
+    throw;
+  }
+  delete next;
+}
+
 template <class T>
-void SolveEfgLcp<T>::FillTableau(const BehavSupport &p_support, Matrix<T> &A,
+void SolveEfgLcp<T>::FillTableau(const BehavSupport &p_support, SparseMatrix<T> &A,
 				 const GameNode &n, T prob,
 				 int s1, int s2, int i1, int i2)
 {
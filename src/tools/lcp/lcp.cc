@@ -28,6 +28,7 @@
 #include <getopt.h>
 #include "libgambit/libgambit.h"
 #include "libgambit/subgame.h"
+#include "libgambit/threads.h"
 
 using namespace Gambit;
 
@@ -36,6 +37,7 @@ List<MixedBehavProfile<T> > SolveExtensive(const BehavSupport &p);
 template <class T>
 List<MixedBehavProfile<T> > SolveExtensiveSilent(const BehavSupport &p);
 template <class T> void SolveStrategic(const Game &p_game);
+void SolveStrategicHybrid(const Game &p_game);
 
 void PrintBanner(std::ostream &p_stream)
 {
@@ -60,6 +62,10 @@ void PrintHelp(char *progname)
   std::cerr << "                   (default is to find all accessible equilbria\n";
   std::cerr << "  -r DEPTH         terminate recursion at DEPTH\n";
   std::cerr << "                   (only if number of equilibria sought is not 1)\n";
+  std::cerr << "  -t THREADS       number of threads used in following paths\n";
+  std::cerr << "                   (default is 1)\n";
+  std::cerr << "  -H               compute in floating point, then check and\n";
+  std::cerr << "                   repair the results in exact arithmetic\n";
   std::cerr << "  -D               print detailed information about equilibria\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
@@ -71,6 +77,8 @@ int g_numDecimals = 6;
 bool g_printDetail = false;
 int g_stopAfter = 0;
 int g_maxDepth = 0;
+int g_numThreads = 1;
+bool g_hybrid = false;
 
 extern void PrintProfile(std::ostream &, const std::string &,
 			 const MixedBehavProfile<double> &);
@@ -89,7 +97,7 @@ int main(int argc, char *argv[])
     { "version", 0, NULL, 'v'  },
     { 0,    0,    0,    0   }
   };
-  while ((c = getopt_long(argc, argv, "d:DvhqSPe:r:", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:DvhHqSPe:r:t:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -112,6 +120,15 @@ int main(int argc, char *argv[])
     case 'r':
       g_maxDepth = atoi(optarg);
       break;
+    case 't':
+      g_numThreads = atoi(optarg);
+      if (g_numThreads <= 0) {
+	g_numThreads = NumProcessors();
+      }
+      break;
+    case 'H':
+      g_hybrid = true;
+      break;
     case 'S':
       useStrategic = true;
       break;
@@ -131,6 +148,11 @@ int main(int argc, char *argv[])
     }
   }
 
+  if (useFloat) {
+    // the results are in floating point already
+    g_hybrid = false;
+  }
+
   if (!quiet) {
     PrintBanner(std::cerr);
   }
@@ -160,6 +182,9 @@ int main(int argc, char *argv[])
       if (useFloat) {
 	SolveStrategic<double>(game);
       }
+      else if (g_hybrid) {
+	SolveStrategicHybrid(game);
+      }
       else {
 	SolveStrategic<Rational>(game);
       }
@@ -41,6 +41,7 @@ public:
     const char *what(void) const throw() { return "Bad Exit Index in LTableau"; }
   };
   LTableau(const Gambit::Matrix<T> &A, const Gambit::Vector<T> &b);
+  LTableau(const SparseMatrix<T> &A, const Gambit::Vector<T> &b);
   LTableau(Tableau<T> &);
   virtual ~LTableau();
 
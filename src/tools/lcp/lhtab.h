@@ -57,6 +57,8 @@ public:
   int CanPivot(int outgoing,int incoming);
   void Pivot(int outrow,int inlabel);
       // perform pivot operation -- outgoing is row, incoming is column
+  void SetBasis(const Gambit::Array<int> &labels);
+      // pivot to the basis whose variables are those in labels
   long NumPivots() const;
   
       // raw Tableau functions
@@ -23,13 +23,15 @@
 #include <cstdio>
 #include <unistd.h>
 #include <iostream>
+#include <set>
 
 #include "libgambit/libgambit.h"
+#include "libgambit/threads.h"
 #include "lhtab.h"
 
 using namespace Gambit;
 
-extern int g_numDecimals, g_stopAfter, g_maxDepth;
+extern int g_numDecimals, g_stopAfter, g_maxDepth, g_numThreads;
 extern bool g_printDetail;
 
 namespace {
@@ -122,18 +124,19 @@ template <class T> Vector<T> Make_b2(const StrategySupport &);
 // If it is not already in the list p_list, it is added.
 // The corresponding equilibrium is computed and output.
 // Returns 'true' if the CBFS is new; 'false' if it already appears in the
-// list.
+// list.  In either case, p_index is set to its position in the list.
 //
 template <class T>
 bool OnBFS(const StrategySupport &p_support,
-	   List<BFS<T> > &p_list, LHTableau<T> &p_tableau)
+	   BFSList<T> &p_list, LHTableau<T> &p_tableau, int &p_index)
 {
   BFS<T> cbfs(p_tableau.GetBFS());
-  if (p_list.Contains(cbfs)) {
+  p_index = p_list.Find(cbfs);
+  if (p_index > 0) {
     return false;
   }
 
-  p_list.Append(cbfs);
+  p_index = p_list.Append(cbfs);
 
   MixedStrategyProfile<T> profile(p_support.NewMixedStrategyProfile<T>());
   int n1 = p_support.NumStrategies(1);
@@ -192,9 +195,16 @@ bool OnBFS(const StrategySupport &p_support,
 // From each new accessible equilibrium, it follows
 // all possible paths, adding any new equilibria to the List.  
 //
+// Paths are reversible: the path dropping a label from the equilibrium
+// at which it ends leads back to where it began.  p_followed holds the
+// pairs (equilibrium, label) for the ends of the paths followed so far,
+// identifying equilibria by their index in p_list, and these paths are
+// not followed again.
+//
 template <class T> void AllLemke(const StrategySupport &p_support,
 				 int j, LHTableau<T> &B,
-				 List<BFS<T> > &p_list,
+				 BFSList<T> &p_list,
+				 std::set<std::pair<int, int> > &p_followed,
 				 int depth)
 {
   if (g_maxDepth != 0 && depth > g_maxDepth) {
@@ -203,24 +213,139 @@ template <class T> void AllLemke(const StrategySupport &p_support,
 
   // On the initial depth=0 call, the CBFS we are at is the extraneous
   // solution.
-  if (depth > 0 && !OnBFS(p_support, p_list, B)) {
-    return;
+  int index = 0;
+  if (depth > 0) {
+    bool isNew = OnBFS(p_support, p_list, B, index);
+    p_followed.insert(std::make_pair(index, j));
+    if (!isNew) {
+      return;
+    }
   }
   
   for (int i = B.MinCol(); i <= B.MaxCol(); i++) {
-    if (i != j)  {
+    if (i != j && p_followed.count(std::make_pair(index, i)) == 0)  {
       LHTableau<T> Bcopy(B);
       Bcopy.LemkePath(i);
-      AllLemke(p_support, i, Bcopy, p_list, depth+1);
+      AllLemke(p_support, i, Bcopy, p_list, p_followed, depth+1);
     }
   }
 }
 
+//
+// A Lemke path waiting to be followed in the parallel search: the
+// tableau is at the equilibrium from which the path starts, which has
+// the given index in the list of equilibria, and the path is followed
+// by dropping the label.
+//
+template <class T> class LemkeStep {
+public:
+  LHTableau<T> m_tableau;
+  int m_index, m_label, m_depth;
+
+  LemkeStep(const LHTableau<T> &p_tableau, int p_index, int p_label, 
+	    int p_depth)
+    : m_tableau(p_tableau), m_index(p_index), m_label(p_label), 
+      m_depth(p_depth)
+  { m_tableau.Refactor(); }
+};
+
+//
+// The parallel counterpart of AllLemke.  Each path is a separate item
+// of work, taken by whichever thread is free; the equilibria found are
+// shared, so that each is expanded only by the thread which first
+// reaches it.
+//
+template <class T> class AllLemkeTask : public ThreadTask {
+private:
+  const StrategySupport &m_support;
+  BFSList<T> &m_list;
+  std::set<std::pair<int, int> > m_followed;
+  WorkStack<LemkeStep<T> *> m_steps;
+  Mutex m_mutex;      // protects m_list, m_followed, and the output
+
+  bool IsFollowed(int p_index, int p_label);
+
+public:
+  AllLemkeTask(const StrategySupport &p_support, BFSList<T> &p_list)
+    : m_support(p_support), m_list(p_list) { }
+  virtual ~AllLemkeTask();
+
+  // Adds the paths leaving the equilibrium at which the tableau is based,
+  // other than those already followed in reverse.  Copies of the tableau
+  // are refactored, so they can be used independently of the original.
+  void AddSteps(const LHTableau<T> &p_tableau, int p_index, int p_depth);
+  void Run(void);
+};
+
+template <class T> AllLemkeTask<T>::~AllLemkeTask()
+{
+  LemkeStep<T> *step;
+  while (m_steps.TryPop(step)) {
+    delete step;
+  }
+}
+
+template <class T> 
+bool AllLemkeTask<T>::IsFollowed(int p_index, int p_label)
+{
+  MutexLock lock(m_mutex);
+  return (m_followed.count(std::make_pair(p_index, p_label)) > 0);
+}
+
+template <class T> 
+void AllLemkeTask<T>::AddSteps(const LHTableau<T> &p_tableau, 
+			       int p_index, int p_depth)
+{
+  if (g_maxDepth != 0 && p_depth > g_maxDepth) {
+    return;
+  }
+  // Added in reverse, so the paths are taken in order by a single thread
+  for (int i = p_tableau.MaxCol(); i >= p_tableau.MinCol(); i--) {
+    if (!IsFollowed(p_index, i)) {
+      m_steps.Push(new LemkeStep<T>(p_tableau, p_index, i, p_depth));
+    }
+  }
+}
+
+template <class T> void AllLemkeTask<T>::Run(void)
+{
+  LemkeStep<T> *step;
+  while (m_steps.Pop(step)) {
+    try {
+      // The reverse of this path may have been followed since it was added
+      if (!IsFollowed(step->m_index, step->m_label)) {
+	step->m_tableau.LemkePath(step->m_label);
+	bool isNew;
+	int index;
+	{
+	  MutexLock lock(m_mutex);
+	  isNew = OnBFS(m_support, m_list, step->m_tableau, index);
+	  m_followed.insert(std::make_pair(index, step->m_label));
+	}
+	if (isNew) {
+	  AddSteps(step->m_tableau, index, step->m_depth + 1);
+	}
+      }
+    }
+    catch (EquilibriumLimitReachedNfg &) {
+      m_steps.Stop();
+    }
+    catch (...) {
+      m_steps.Stop();
+      delete step;
+      m_steps.Done();
+      throw;
+    }
+    delete step;
+    m_steps.Done();
+  }
+}
+
 template <class T>
 void SolveStrategic(const Game &p_game)
 {
   StrategySupport support(p_game);
-  List<BFS<T> > bfsList;
+  BFSList<T> bfsList;
 
   try {
     Matrix<T> A1 = Make_A1<T>(support);
@@ -229,9 +354,15 @@ void SolveStrategic(const Game &p_game)
     Vector<T> b2 = Make_b2<T>(support);
     LHTableau<T> B(A1, A2, b1, b2);
 
-    if (g_stopAfter != 1) {
+    if (g_stopAfter != 1 && g_numThreads > 1) {
+      AllLemkeTask<T> task(support, bfsList);
+      task.AddSteps(B, 0, 1);
+      RunThreads(task, g_numThreads);
+    }
+    else if (g_stopAfter != 1) {
+      std::set<std::pair<int, int> > followed;
       try {
-	AllLemke(support, 0, B, bfsList, 0);
+	AllLemke(support, 0, B, bfsList, followed, 0);
       }
       catch (EquilibriumLimitReachedNfg &) {
 	// This pseudo-exception requires no additional action;
@@ -240,7 +371,8 @@ void SolveStrategic(const Game &p_game)
     }
     else  {
       B.LemkePath(1);
-      OnBFS(support, bfsList, B);
+      int index;
+      OnBFS(support, bfsList, B, index);
     }
 
     return;
@@ -255,4 +387,117 @@ void SolveStrategic(const Game &p_game)
 template void SolveStrategic<double>(const Game &);
 template void SolveStrategic<Rational>(const Game &);
 
+//
+// In hybrid mode, the paths are followed in floating point.  At the end
+// of each, the exact tableau at the start of the path is pivoted to the
+// basis reached, and the equilibrium is accepted if that basis is
+// nonsingular and feasible in exact arithmetic.  Otherwise, the path is
+// followed again exactly, and the floating-point tableau is moved to the
+// basis reached there, so the equilibria found are exactly those of the
+// exact search.
+//
+template <class T> Array<int> BasisLabels(const LHTableau<T> &p_tableau)
+{
+  Array<int> labels;
+  for (int i = p_tableau.MinRow(); i <= p_tableau.MaxRow(); i++) {
+    labels.Append(p_tableau.Label(i));
+  }
+  return labels;
+}
+
+static bool IsFeasible(LHTableau<Rational> &p_tableau)
+{
+  BFS<Rational> cbfs(p_tableau.GetBFS());
+  for (int i = p_tableau.MinCol(); i <= p_tableau.MaxCol(); i++) {
+    // with the right-hand side -1, basic variables are nonpositive
+    if (cbfs[i] > Rational(0))  return false;
+  }
+  return true;
+}
+
+//
+// Brings p_exact, which is a copy of the exact tableau at the start of
+// the path p_label followed by p_float, to the end of the path
+//
+static void CertifyPath(LHTableau<double> &p_float, int p_label,
+			LHTableau<Rational> &p_exact)
+{
+  LHTableau<Rational> start(p_exact);
+  try {
+    p_exact.SetBasis(BasisLabels(p_float));
+    if (IsFeasible(p_exact))  return;
+  }
+  catch (Exception &) {
+    // the basis is singular in exact arithmetic
+  }
+
+  p_exact = start;
+  p_exact.LemkePath(p_label);
+  p_float.SetBasis(BasisLabels(p_exact));
+}
+
+static void AllLemkeHybrid(const StrategySupport &p_support,
+			   int j, LHTableau<double> &B,
+			   LHTableau<Rational> &E,
+			   BFSList<Rational> &p_list,
+			   std::set<std::pair<int, int> > &p_followed,
+			   int depth)
+{
+  if (g_maxDepth != 0 && depth > g_maxDepth) {
+    return;
+  }
+
+  int index = 0;
+  if (depth > 0) {
+    bool isNew = OnBFS(p_support, p_list, E, index);
+    p_followed.insert(std::make_pair(index, j));
+    if (!isNew) {
+      return;
+    }
+  }
+  
+  for (int i = B.MinCol(); i <= B.MaxCol(); i++) {
+    if (i != j && p_followed.count(std::make_pair(index, i)) == 0)  {
+      LHTableau<double> Bcopy(B);
+      LHTableau<Rational> Ecopy(E);
+      Bcopy.LemkePath(i);
+      CertifyPath(Bcopy, i, Ecopy);
+      AllLemkeHybrid(p_support, i, Bcopy, Ecopy, p_list, p_followed, depth+1);
+    }
+  }
+}
+
+void SolveStrategicHybrid(const Game &p_game)
+{
+  StrategySupport support(p_game);
+  BFSList<Rational> bfsList;
+
+  Matrix<double> fA1 = Make_A1<double>(support);
+  Vector<double> fb1 = Make_b1<double>(support);
+  Matrix<double> fA2 = Make_A2<double>(support);
+  Vector<double> fb2 = Make_b2<double>(support);
+  LHTableau<double> B(fA1, fA2, fb1, fb2);
+  Matrix<Rational> A1 = Make_A1<Rational>(support);
+  Vector<Rational> b1 = Make_b1<Rational>(support);
+  Matrix<Rational> A2 = Make_A2<Rational>(support);
+  Vector<Rational> b2 = Make_b2<Rational>(support);
+  LHTableau<Rational> E(A1, A2, b1, b2);
+
+  try {
+    if (g_stopAfter != 1) {
+      std::set<std::pair<int, int> > followed;
+      AllLemkeHybrid(support, 0, B, E, bfsList, followed, 0);
+    }
+    else {
+      B.LemkePath(1);
+      CertifyPath(B, 1, E);
+      int index;
+      OnBFS(support, bfsList, E, index);
+    }
+  }
+  catch (EquilibriumLimitReachedNfg &) {
+    // bfsList will contain the list of equilibria found
+  }
+}
+
 
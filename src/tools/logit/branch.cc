@@ -0,0 +1,157 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/logit/branch.cc
+// Storage and interpolation of a traced branch of a smooth path
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+
+#include <libgambit/libgambit.h>
+using namespace Gambit;
+
+#include "branch.h"
+
+//----------------------------------------------------------------------------
+//                     PathBranch: Auxiliary functions
+//----------------------------------------------------------------------------
+
+//
+// Evaluates coordinate k of the cubic Hermite interpolant between
+// (x0, t0) and (x1, t1) at u in [0,1]; the tangents are scaled by
+// the length of the segment.
+//
+static double Hermite(const Vector<double> &x0, const Vector<double> &t0,
+		      const Vector<double> &x1, const Vector<double> &t1,
+		      double p_length, int k, double u)
+{
+  double u2 = u * u, u3 = u2 * u;
+  return ((2.0*u3 - 3.0*u2 + 1.0) * x0[k] +
+	  (u3 - 2.0*u2 + u) * p_length * t0[k] +
+	  (-2.0*u3 + 3.0*u2) * x1[k] +
+	  (u3 - u2) * p_length * t1[k]);
+}
+
+//----------------------------------------------------------------------------
+//                     PathBranch: Member functions
+//----------------------------------------------------------------------------
+
+void PathBranch::Append(const Vector<double> &p_point,
+			const Vector<double> &p_tangent)
+{
+  if (m_points.Length() > 0 &&
+      (p_point.Length() != Dimension() || p_tangent.Length() != Dimension())) {
+    throw DimensionException();
+  }
+  m_points.Append(p_point);
+  m_tangents.Append(p_tangent);
+}
+
+bool PathBranch::Interpolate(double p_param, Vector<double> &p_point) const
+{
+  const int c_maxBisect = 60;    // iterations in locating the parameter
+
+  int n = Dimension();
+  for (int i = 1; i < m_points.Length(); i++) {
+    const Vector<double> &x0 = m_points[i], &x1 = m_points[i+1];
+    double g0 = x0[n] - p_param, g1 = x1[n] - p_param;
+    if (g0 == 0.0) {
+      p_point = x0;
+      return true;
+    }
+    if (g0 * g1 > 0.0) {
+      continue;
+    }
+
+    const Vector<double> &t0 = m_tangents[i], &t1 = m_tangents[i+1];
+    Vector<double> diff(x1 - x0);
+    double length = sqrt(diff * diff);
+
+    // Locate the parameter value on the segment by bisection
+    double lo = 0.0, hi = 1.0;
+    for (int iter = 0; iter < c_maxBisect; iter++) {
+      double mid = 0.5 * (lo + hi);
+      double g = Hermite(x0, t0, x1, t1, length, n, mid) - p_param;
+      if ((g < 0.0) == (g0 < 0.0)) {
+	lo = mid;
+      }
+      else {
+	hi = mid;
+      }
+    }
+
+    double u = 0.5 * (lo + hi);
+    for (int k = 1; k < n; k++) {
+      p_point[k] = Hermite(x0, t0, x1, t1, length, k, u);
+    }
+    p_point[n] = p_param;
+    return true;
+  }
+
+  if (m_points.Length() > 0 && m_points[m_points.Length()][n] == p_param) {
+    p_point = m_points[m_points.Length()];
+    return true;
+  }
+  return false;
+}
+
+void PathBranch::Write(std::ostream &p_stream) const
+{
+  p_stream << Dimension() << " " << NumPoints() << std::endl;
+  p_stream << std::setprecision(17);
+  for (int i = 1; i <= m_points.Length(); i++) {
+    const Vector<double> &x = m_points[i], &t = m_tangents[i];
+    for (int k = 1; k <= x.Length(); k++) {
+      p_stream << x[k] << " ";
+    }
+    for (int k = 1; k <= t.Length(); k++) {
+      p_stream << t[k] << ((k < t.Length()) ? " " : "\n");
+    }
+  }
+}
+
+void PathBranch::Read(std::istream &p_stream)
+{
+  int dimension, numPoints;
+  if (!(p_stream >> dimension >> numPoints) ||
+      dimension < 1 || numPoints < 0) {
+    throw InvalidFileException();
+  }
+
+  List<Vector<double> > points, tangents;
+  Vector<double> x(dimension), t(dimension);
+  for (int i = 1; i <= numPoints; i++) {
+    for (int k = 1; k <= dimension; k++) {
+      if (!(p_stream >> x[k])) {
+	throw InvalidFileException();
+      }
+    }
+    for (int k = 1; k <= dimension; k++) {
+      if (!(p_stream >> t[k])) {
+	throw InvalidFileException();
+      }
+    }
+    points.Append(x);
+    tangents.Append(t);
+  }
+
+  m_points = points;
+  m_tangents = tangents;
+}
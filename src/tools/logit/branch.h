@@ -0,0 +1,69 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/logit/branch.h
+// Storage and interpolation of a traced branch of a smooth path
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef BRANCH_H
+#define BRANCH_H
+
+using namespace Gambit;
+
+//
+// This class stores the points accepted while tracing a path, together
+// with the (unit) tangents in the direction of travel at each point.
+// As in PathTracer, the last coordinate of each point is the parameter.
+// Points between those stored are computed by cubic Hermite interpolation
+// along the branch, using the chord length between consecutive points
+// as an approximation to the arclength.
+//
+class PathBranch {
+public:
+  PathBranch(void) { }
+  ~PathBranch() { }
+
+  int NumPoints(void) const { return m_points.Length(); }
+  // The number of coordinates in each point, including the parameter
+  int Dimension(void) const
+    { return (m_points.Length() > 0) ? m_points[1].Length() : 0; }
+  void Clear(void) { m_points = List<Vector<double> >();
+                     m_tangents = List<Vector<double> >(); }
+
+  void Append(const Vector<double> &p_point, const Vector<double> &p_tangent);
+  const Vector<double> &GetPoint(int i) const { return m_points[i]; }
+  const Vector<double> &GetTangent(int i) const { return m_tangents[i]; }
+
+  // Computes the first point along the branch at which the parameter
+  // equals p_param.  Returns false if the parameter does not take on
+  // this value between the first and last points stored.
+  bool Interpolate(double p_param, Vector<double> &p_point) const;
+
+  // Writes the branch as text: a line giving the dimension and number of
+  // points, followed by one line for each point, listing its coordinates
+  // and then the coordinates of its tangent.
+  void Write(std::ostream &p_stream) const;
+  // Reads a branch written by Write(), replacing the current contents.
+  // Throws InvalidFileException if the stream is not in this format.
+  void Read(std::istream &p_stream);
+
+private:
+  List<Vector<double> > m_points, m_tangents;
+};
+
+#endif  // BRANCH_H
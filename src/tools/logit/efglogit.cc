@@ -186,7 +186,8 @@ void RatioEquation::Gradient(const LogBehavProfile<double> &p_profile,
 //------------------------------------------------------------------------------
 
 AgentQREPathTracer::AgentQREPathTracer(const MixedBehavProfile<double> &p_start) 
-  : m_start(p_start), m_fullGraph(true), m_decimals(6)
+  : m_start(p_start), m_fullGraph(true), m_decimals(6),
+    m_stream(&std::cout)
 { 
   SetTargetParam(-1.0);
   for (int pl = 1; pl <= p_start.GetGame()->NumPlayers(); pl++) {
@@ -225,6 +226,28 @@ AgentQREPathTracer::TraceAgentPath(const MixedBehavProfile<double> &p_start,
   TracePath(x, p_maxLambda, p_omega);
 }
 
+bool
+AgentQREPathTracer::SolveAtLambda(double p_lambda,
+				  MixedBehavProfile<double> &p_profile)
+{
+  // The principal branch starts at the centroid
+  MixedBehavProfile<double> centroid(m_start.GetGame());
+  Vector<double> origin(centroid.Length() + 1);
+  for (int i = 1; i <= centroid.Length(); i++) {
+    origin[i] = log(centroid[i]);
+  }
+  origin[origin.Length()] = 0.0;
+
+  Vector<double> x(origin.Length());
+  if (!SolveAtParam(p_lambda, origin, x)) {
+    return false;
+  }
+  for (int i = 1; i <= p_profile.Length(); i++) {
+    p_profile[i] = exp(x[i]);
+  }
+  return true;
+}
+
 //------------------------------------------------------------------------------
 //               AgentQREPathTracer: Providing virtual functions
 //------------------------------------------------------------------------------
@@ -307,7 +330,7 @@ AgentQREPathTracer::OnStep(const Vector<double> &x,
 			   bool p_isTerminal = false)
 {
   if ((m_fullGraph && !p_isTerminal) || (!m_fullGraph && p_isTerminal)) {
-    PrintProfile(std::cout, x, p_isTerminal);
+    PrintProfile(*m_stream, x, p_isTerminal);
   }
 }
 
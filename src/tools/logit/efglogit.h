@@ -43,6 +43,15 @@ public:
   void SetDecimals(int p_decimals) { m_decimals = p_decimals; }
   int GetDecimals(void) const { return m_decimals; }
 
+  // Compute the agent QRE on the principal branch at p_lambda directly,
+  // without tracing the branch from the centroid where possible.
+  // Returns false if no such point could be found.
+  bool SolveAtLambda(double p_lambda, MixedBehavProfile<double> &p_profile);
+
+  // Stream to which the points on the branch are written
+  void SetStream(std::ostream &p_stream) { m_stream = &p_stream; }
+  std::ostream &GetStream(void) const { return *m_stream; }
+
 protected:
   virtual void OnStep(const Vector<double> &, bool);
 
@@ -58,6 +67,7 @@ private:
   Array<Equation *> m_equations;
   bool m_fullGraph;
   int m_decimals;
+  std::ostream *m_stream;
 
   void PrintProfile(std::ostream &p_stream, const Vector<double> &x,
 		    bool p_isTerminal);
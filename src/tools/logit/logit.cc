@@ -28,6 +28,7 @@
 #include <unistd.h>
 #include <getopt.h>
 #include "libgambit/libgambit.h"
+#include "libgambit/threads.h"
 #include "efglogit.h"
 #include "nfglogit.h"
 
@@ -50,10 +51,23 @@ void PrintHelp(char *progname)
   std::cerr << "  -d DECIMALS      show equilibria as floating point with DECIMALS digits\n";
   std::cerr << "  -s STEP          initial stepsize (default is .03)\n";
   std::cerr << "  -a ACCEL         maximum acceleration (default is 1.1)\n";
+  std::cerr << "  -b               use Broyden updates of the Jacobian in the corrector\n";
   std::cerr << "  -m MAXLAMBDA     stop when reaching MAXLAMBDA (default is 1000000)\n";
   std::cerr << "  -l LAMBDA        compute QRE at `lambda` accurately\n";
+  std::cerr << "  -f LAMBDAS       compute QRE directly at each value in the\n";
+  std::cerr << "                   comma-separated list LAMBDAS, without\n";
+  std::cerr << "                   tracing the branch\n";
   std::cerr << "  -L FILE          compute maximum likelihood estimates;\n";
   std::cerr << "                   read strategy frequencies from FILE\n";
+  std::cerr << "  -E               with -L, print only the estimate of lambda,\n";
+  std::cerr << "                   with its log-likelihood and standard error\n";
+  std::cerr << "  -w FILE          write the traced branch to FILE\n";
+  std::cerr << "  -r FILE          read a branch written by -w from FILE, and\n";
+  std::cerr << "                   interpolate along it in computing QRE with -f\n";
+  std::cerr << "  -B               batch mode: input is a sequence of games; each\n";
+  std::cerr << "                   output line is prefixed with the game's number\n";
+  std::cerr << "  -t THREADS       number of threads to use in batch mode\n";
+  std::cerr << "                   (default is the number of processors)\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
   std::cerr << "  -e               print only the terminal equilibrium\n";
@@ -85,6 +99,287 @@ bool ReadProfile(std::istream &p_stream, Gambit::Array<double> &p_profile)
 }
 
 
+//
+// Read a comma-separated list of values of lambda
+//
+bool ParseLambdas(const std::string &p_text, Gambit::List<double> &p_lambdas)
+{
+  std::istringstream stream(p_text);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    char *end;
+    double lambda = strtod(item.c_str(), &end);
+    if (end == item.c_str() || *end != '\0' || lambda < 0.0) {
+      return false;
+    }
+    p_lambdas.Append(lambda);
+  }
+  return (p_lambdas.Length() > 0);
+}
+
+void PrintQRE(std::ostream &p_stream, double p_lambda,
+	      const Gambit::Vector<double> &p_profile, int p_decimals)
+{
+  p_stream.setf(std::ios::fixed);
+  p_stream << std::setprecision(p_decimals) << p_lambda;
+  p_stream.unsetf(std::ios::fixed);
+  for (int i = 1; i <= p_profile.Length(); i++) {
+    p_stream << "," << std::setprecision(p_decimals) << p_profile[i];
+  }
+  p_stream << std::endl;
+}
+
+//
+// Writes a maximum likelihood estimate: lambda, the profile, the
+// log-likelihood, and the standard error of lambda.
+//
+void PrintEstimate(std::ostream &p_stream, double p_lambda,
+		   const Gambit::Vector<double> &p_profile, 
+		   double p_logLike, double p_stdErr, int p_decimals)
+{
+  p_stream.setf(std::ios::fixed);
+  p_stream << std::setprecision(p_decimals) << p_lambda;
+  p_stream.unsetf(std::ios::fixed);
+  for (int i = 1; i <= p_profile.Length(); i++) {
+    p_stream << "," << std::setprecision(p_decimals) << p_profile[i];
+  }
+  p_stream.setf(std::ios::fixed);
+  p_stream << "," << std::setprecision(p_decimals) << p_logLike;
+  p_stream << "," << std::setprecision(p_decimals) << p_stdErr;
+  p_stream.unsetf(std::ios::fixed);
+  p_stream << std::endl;
+}
+
+//
+// Computes the QRE directly at each of the values of lambda in turn,
+// writing one line for each to the stream.  If a branch is given,
+// it supplies the starting points for the computation.  Returns false
+// if the QRE could not be found for any of the values.
+//
+bool SolveAtLambdas(const Gambit::Game &p_game, bool p_useStrategic,
+		    double p_maxDecel, double p_hStart, bool p_broyden,
+		    int p_decimals, const Gambit::List<double> &p_lambdas,
+		    std::ostream &p_stream, const PathBranch *p_branch = 0)
+{
+  bool ok = true;
+  if (!p_game->IsTree() || p_useStrategic) {
+    Gambit::MixedStrategyProfile<double> start(p_game->NewMixedStrategyProfile(0.0));
+    StrategicQREPathTracer tracer(start);
+    tracer.SetMaxDecel(p_maxDecel);
+    tracer.SetStepsize(p_hStart);
+    tracer.SetBroydenUpdates(p_broyden);
+    if (p_branch) {
+      tracer.SetBranch(*p_branch);
+    }
+    for (int i = 1; i <= p_lambdas.Length(); i++) {
+      Gambit::MixedStrategyProfile<double> profile(start);
+      if (tracer.SolveAtLambda(p_lambdas[i], profile)) {
+	PrintQRE(p_stream, p_lambdas[i], profile, p_decimals);
+      }
+      else {
+	ok = false;
+      }
+    }
+  }
+  else {
+    MixedBehavProfile<double> start(p_game);
+    AgentQREPathTracer tracer(start);
+    tracer.SetMaxDecel(p_maxDecel);
+    tracer.SetStepsize(p_hStart);
+    tracer.SetBroydenUpdates(p_broyden);
+    if (p_branch) {
+      tracer.SetBranch(*p_branch);
+    }
+    for (int i = 1; i <= p_lambdas.Length(); i++) {
+      MixedBehavProfile<double> profile(start);
+      if (tracer.SolveAtLambda(p_lambdas[i], profile)) {
+	PrintQRE(p_stream, p_lambdas[i], profile, p_decimals);
+      }
+      else {
+	ok = false;
+      }
+    }
+  }
+  return ok;
+}
+
+//
+// Writes the branch recorded by a tracer to the file.  Returns false
+// if the file could not be written.
+//
+bool WriteBranch(const PathBranch &p_branch, const std::string &p_file)
+{
+  std::ofstream stream(p_file.c_str());
+  if (!stream.is_open()) {
+    return false;
+  }
+  p_branch.Write(stream);
+  return stream.good();
+}
+
+//
+// Splits a stream of concatenated savefiles into the text of the
+// individual games.  Each game starts at a line beginning with the
+// NFG or EFG keyword.
+//
+void ReadGameTexts(std::istream &p_stream, Gambit::List<std::string> &p_texts)
+{
+  std::string line, text;
+  while (std::getline(p_stream, line)) {
+    std::string::size_type start = line.find_first_not_of(" \t\r");
+    if (start != std::string::npos &&
+	(line.compare(start, 3, "NFG") == 0 || 
+	 line.compare(start, 3, "EFG") == 0) &&
+	text.find_first_not_of(" \t\r\n") != std::string::npos) {
+      p_texts.Append(text);
+      text = "";
+    }
+    text += line + "\n";
+  }
+  if (text.find_first_not_of(" \t\r\n") != std::string::npos) {
+    p_texts.Append(text);
+  }
+}
+
+//
+// Traces the branches for a sequence of games on a pool of threads.
+// Each thread repeatedly takes the next untraced game; the output for
+// each game is collected and written out, in the order the games were
+// given, as soon as it and all the games before it are complete.
+//
+class LogitBatch : public Gambit::ThreadTask {
+public:
+  LogitBatch(const Gambit::List<std::string> &p_games, std::ostream &p_stream)
+    : m_games(p_games), m_stream(p_stream), m_nextGame(1), m_nextOutput(1),
+      m_results(p_games.Length()), m_done(p_games.Length()), m_errors(0),
+      m_maxLambda(1000000.0), m_maxDecel(1.1), m_hStart(0.03),
+      m_targetLambda(-1.0), m_fullGraph(true), m_broyden(false),
+      m_useStrategic(false), m_decimals(6)
+  { 
+    for (int i = 1; i <= m_done.Length(); i++) {
+      m_done[i] = false;
+    }
+  }
+  virtual ~LogitBatch() { }
+
+  void SetParameters(double p_maxLambda, double p_maxDecel, double p_hStart,
+		     double p_targetLambda, bool p_fullGraph, bool p_broyden,
+		     bool p_useStrategic, int p_decimals)
+  {
+    m_maxLambda = p_maxLambda;  m_maxDecel = p_maxDecel;
+    m_hStart = p_hStart;  m_targetLambda = p_targetLambda;
+    m_fullGraph = p_fullGraph;  m_broyden = p_broyden;
+    m_useStrategic = p_useStrategic;  m_decimals = p_decimals;
+  }
+
+  void SetLambdas(const Gambit::List<double> &p_lambdas)
+  { m_lambdas = p_lambdas; }
+
+  int NumErrors(void) const { return m_errors; }
+
+  void Run(void);
+
+private:
+  const Gambit::List<std::string> &m_games;
+  std::ostream &m_stream;
+  Gambit::Mutex m_mutex;
+  int m_nextGame, m_nextOutput;
+  Gambit::Array<std::string> m_results;
+  Gambit::Array<bool> m_done;
+  int m_errors;
+
+  double m_maxLambda, m_maxDecel, m_hStart, m_targetLambda;
+  bool m_fullGraph, m_broyden, m_useStrategic;
+  int m_decimals;
+  Gambit::List<double> m_lambdas;
+
+  std::string Trace(int p_index);
+};
+
+std::string LogitBatch::Trace(int p_index)
+{
+  std::istringstream input(m_games[p_index]);
+  Gambit::Game game = Gambit::ReadGame(input);
+
+  std::ostringstream output;
+  if (m_lambdas.Length() > 0) {
+    if (!SolveAtLambdas(game, m_useStrategic, m_maxDecel, m_hStart, m_broyden,
+			m_decimals, m_lambdas, output)) {
+      throw Gambit::ValueException();
+    }
+  }
+  else if (!game->IsTree() || m_useStrategic) {
+    Gambit::MixedStrategyProfile<double> start(game->NewMixedStrategyProfile(0.0));
+    StrategicQREPathTracer tracer(start);
+    tracer.SetMaxDecel(m_maxDecel);
+    tracer.SetStepsize(m_hStart);
+    tracer.SetBroydenUpdates(m_broyden);
+    tracer.SetFullGraph(m_fullGraph);
+    tracer.SetTargetParam(m_targetLambda);
+    tracer.SetDecimals(m_decimals);
+    tracer.SetStream(output);
+    tracer.TraceStrategicPath(start, 0.0, m_maxLambda, 1.0);
+  }
+  else {
+    MixedBehavProfile<double> start(game);
+    AgentQREPathTracer tracer(start);
+    tracer.SetMaxDecel(m_maxDecel);
+    tracer.SetStepsize(m_hStart);
+    tracer.SetBroydenUpdates(m_broyden);
+    tracer.SetFullGraph(m_fullGraph);
+    tracer.SetTargetParam(m_targetLambda);
+    tracer.SetDecimals(m_decimals);
+    tracer.SetStream(output);
+    tracer.TraceAgentPath(start, 0.0, m_maxLambda, 1.0);
+  }
+
+  // Tag each line of output with the number of the game
+  std::istringstream lines(output.str());
+  std::ostringstream tagged;
+  std::string line;
+  while (std::getline(lines, line)) {
+    tagged << p_index << "," << line << std::endl;
+  }
+  return tagged.str();
+}
+
+void LogitBatch::Run(void)
+{
+  while (true) {
+    int index;
+    {
+      Gambit::MutexLock lock(m_mutex);
+      if (m_nextGame > m_games.Length()) {
+	return;
+      }
+      index = m_nextGame++;
+    }
+
+    std::string result;
+    bool failed = false;
+    try {
+      result = Trace(index);
+    }
+    catch (...) {
+      failed = true;
+    }
+
+    Gambit::MutexLock lock(m_mutex);
+    if (failed) {
+      std::cerr << "Error: Game " << index << " could not be solved.\n";
+      m_errors++;
+    }
+    m_results[index] = result;
+    m_done[index] = true;
+    while (m_nextOutput <= m_done.Length() && m_done[m_nextOutput]) {
+      m_stream << m_results[m_nextOutput] << std::flush;
+      m_results[m_nextOutput] = "";
+      m_nextOutput++;
+    }
+  }
+}
+
+
 int main(int argc, char *argv[])
 {
   opterr = 0;
@@ -92,11 +387,16 @@ int main(int argc, char *argv[])
   bool quiet = false, useStrategic = false;
   double maxLambda = 1000000.0;
   std::string mleFile = "", startFile = "";
+  std::string branchOutFile = "", branchInFile = "";
   double maxDecel = 1.1;
   double hStart = 0.03;
+  bool broyden = false, estimate = false;
   double targetLambda = -1.0;
   bool fullGraph = true;
   int decimals = 6;
+  bool batch = false;
+  int numThreads = 0;
+  Gambit::List<double> lambdas;
 
   int long_opt_index = 0;
   struct option long_options[] = {
@@ -105,7 +405,7 @@ int main(int argc, char *argv[])
     { 0,    0,    0,    0   }
   };
   int c;
-  while ((c = getopt_long(argc, argv, "d:s:a:m:vqehSL:p:l:", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:s:a:bm:vqehSL:Ep:l:f:Bt:w:r:", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -121,6 +421,9 @@ int main(int argc, char *argv[])
     case 'a':
       maxDecel = atof(optarg);
       break;
+    case 'b':
+      broyden = true;
+      break;
     case 'm':
       maxLambda = atof(optarg);
       break;
@@ -136,12 +439,33 @@ int main(int argc, char *argv[])
     case 'L':
       mleFile = optarg;
       break;
+    case 'E':
+      estimate = true;
+      break;
     case 'p':
       startFile = optarg;
       break;
     case 'l':
       targetLambda = atof(optarg);
       break;
+    case 'f':
+      if (!ParseLambdas(optarg, lambdas)) {
+	std::cerr << argv[0] << ": Invalid list of lambda values `" << optarg << "'.\n";
+	return 1;
+      }
+      break;
+    case 'w':
+      branchOutFile = optarg;
+      break;
+    case 'r':
+      branchInFile = optarg;
+      break;
+    case 'B':
+      batch = true;
+      break;
+    case 't':
+      numThreads = atoi(optarg);
+      break;
     case '?':
       if (isprint(optopt)) {
 	std::cerr << argv[0] << ": Unknown option `-" << ((char) optopt) << "'.\n";
@@ -159,6 +483,67 @@ int main(int argc, char *argv[])
     PrintBanner(std::cerr);
   }
 
+  if (batch) {
+    if (mleFile != "" || startFile != "") {
+      std::cerr << argv[0] << ": Options -L, -E, and -p are not available in batch mode.\n";
+      return 1;
+    }
+    if (branchOutFile != "" || branchInFile != "") {
+      std::cerr << argv[0] << ": Options -w and -r are not available in batch mode.\n";
+      return 1;
+    }
+
+    Gambit::List<std::string> games;
+    if (optind < argc) {
+      for (int arg = optind; arg < argc; arg++) {
+	std::ifstream file_stream(argv[arg]);
+	if (!file_stream.is_open()) {
+	  std::ostringstream error_message;
+	  error_message << argv[0] << ": " << argv[arg];
+	  perror(error_message.str().c_str());
+	  exit(1);
+	}
+	ReadGameTexts(file_stream, games);
+      }
+    }
+    else {
+      ReadGameTexts(std::cin, games);
+    }
+
+    if (numThreads <= 0) {
+      numThreads = Gambit::NumProcessors();
+    }
+    if (numThreads > games.Length()) {
+      numThreads = games.Length();
+    }
+
+    LogitBatch task(games, std::cout);
+    task.SetParameters(maxLambda, maxDecel, hStart, targetLambda,
+		       fullGraph, broyden, useStrategic, decimals);
+    task.SetLambdas(lambdas);
+    try {
+      Gambit::RunThreads(task, numThreads);
+    }
+    catch (...) {
+      std::cerr << "Error: An internal error occurred.\n";
+      return 1;
+    }
+    return (task.NumErrors() > 0) ? 1 : 0;
+  }
+
+  if (estimate && (mleFile == "" || startFile != "" || batch)) {
+    std::cerr << argv[0] << ": Option -E requires -L, and cannot be used with -p or -B.\n";
+    return 1;
+  }
+  if (branchInFile != "" && lambdas.Length() == 0) {
+    std::cerr << argv[0] << ": Option -r requires -f.\n";
+    return 1;
+  }
+  if (branchOutFile != "" && (lambdas.Length() > 0 || startFile != "")) {
+    std::cerr << argv[0] << ": Option -w cannot be used with -f or -p.\n";
+    return 1;
+  }
+
   std::istream* input_stream = &std::cin;
   std::ifstream file_stream;
   if (optind < argc) { 
@@ -176,11 +561,66 @@ int main(int argc, char *argv[])
     Gambit::Array<double> frequencies;
     Gambit::Game game = Gambit::ReadGame(*input_stream);
 
+    if (lambdas.Length() > 0) {
+      PathBranch branch;
+      if (branchInFile != "") {
+	std::ifstream branchData(branchInFile.c_str());
+	if (!branchData.is_open()) {
+	  std::ostringstream error_message;
+	  error_message << argv[0] << ": " << branchInFile;
+	  perror(error_message.str().c_str());
+	  exit(1);
+	}
+	try {
+	  branch.Read(branchData);
+	}
+	catch (Gambit::InvalidFileException) {
+	  std::cerr << "Error: Branch file not in a recognized format.\n";
+	  return 1;
+	}
+	int length = (!game->IsTree() || useStrategic) ?
+	  game->MixedProfileLength() : game->BehavProfileLength();
+	if (branch.NumPoints() > 0 && branch.Dimension() != length + 1) {
+	  std::cerr << "Error: Branch file does not match the game.\n";
+	  return 1;
+	}
+      }
+      if (!SolveAtLambdas(game, useStrategic, maxDecel, hStart, broyden,
+			  decimals, lambdas, std::cout, 
+			  (branch.NumPoints() > 0) ? &branch : 0)) {
+	std::cerr << "Error: Unable to compute the QRE at all values of lambda.\n";
+	return 1;
+      }
+      return 0;
+    }
+
     if (mleFile != "" && (!game->IsTree() || useStrategic)) {
       frequencies = Gambit::Array<double>(game->MixedProfileLength());
       std::ifstream mleData(mleFile.c_str());
       ReadProfile(mleData, frequencies);
     }
+    else if (estimate) {
+      std::cerr << "Error: Estimation requires a strategic game (use -S for trees).\n";
+      return 1;
+    }
+
+    if (estimate) {
+      Gambit::MixedStrategyProfile<double> start(game->NewMixedStrategyProfile(0.0));
+      StrategicQREPathTracer tracer(start);
+      tracer.SetMaxDecel(maxDecel);
+      tracer.SetStepsize(hStart);
+      tracer.SetBroydenUpdates(broyden);
+      tracer.SetMLEFrequencies(frequencies);
+      double lambda, logLike, stdErr;
+      Gambit::MixedStrategyProfile<double> profile(start);
+      if (!tracer.EstimateMLE(start, maxLambda, lambda, profile,
+			      logLike, stdErr)) {
+	std::cerr << "Error: No maximum of the likelihood found on the branch.\n";
+	return 1;
+      }
+      PrintEstimate(std::cout, lambda, profile, logLike, stdErr, decimals);
+      return 0;
+    }
   
 
     if (!game->IsTree() || useStrategic) {
@@ -189,11 +629,18 @@ int main(int argc, char *argv[])
 	StrategicQREPathTracer tracer(start);
 	tracer.SetMaxDecel(maxDecel);
 	tracer.SetStepsize(hStart);
+	tracer.SetBroydenUpdates(broyden);
 	tracer.SetFullGraph(fullGraph);
 	tracer.SetTargetParam(targetLambda);
 	tracer.SetDecimals(decimals);
 	tracer.SetMLEFrequencies(frequencies);
+	tracer.SetRecordBranch(branchOutFile != "");
 	tracer.TraceStrategicPath(start, 0.0, maxLambda, 1.0);
+	if (branchOutFile != "" &&
+	    !WriteBranch(tracer.GetBranch(), branchOutFile)) {
+	  std::cerr << "Error: Unable to write branch to " << branchOutFile << ".\n";
+	  return 1;
+	}
       }
       else {
 	Gambit::Array<double> profile(game->MixedProfileLength() + 1);
@@ -206,6 +653,7 @@ int main(int argc, char *argv[])
 	StrategicQREPathTracer tracer1(start);
 	tracer1.SetMaxDecel(maxDecel);
 	tracer1.SetStepsize(hStart);
+	tracer1.SetBroydenUpdates(broyden);
 	tracer1.SetFullGraph(fullGraph);
 	tracer1.SetTargetParam(targetLambda);
 	tracer1.SetDecimals(decimals);
@@ -214,6 +662,7 @@ int main(int argc, char *argv[])
 	StrategicQREPathTracer tracer2(start);
 	tracer2.SetMaxDecel(maxDecel);
 	tracer2.SetStepsize(hStart);
+	tracer2.SetBroydenUpdates(broyden);
 	tracer2.SetFullGraph(fullGraph);
 	tracer2.SetTargetParam(targetLambda);
 	tracer2.SetDecimals(decimals);
@@ -226,10 +675,17 @@ int main(int argc, char *argv[])
       AgentQREPathTracer tracer(start);
       tracer.SetMaxDecel(maxDecel);
       tracer.SetStepsize(hStart);
+      tracer.SetBroydenUpdates(broyden);
       tracer.SetFullGraph(fullGraph);
       tracer.SetTargetParam(targetLambda);
       tracer.SetDecimals(decimals);
+      tracer.SetRecordBranch(branchOutFile != "");
       tracer.TraceAgentPath(start, 0.0, maxLambda, 1.0);
+      if (branchOutFile != "" &&
+	  !WriteBranch(tracer.GetBranch(), branchOutFile)) {
+	std::cerr << "Error: Unable to write branch to " << branchOutFile << ".\n";
+	return 1;
+      }
     }
     return 0;
   }
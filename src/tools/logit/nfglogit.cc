@@ -49,7 +49,7 @@ StrategicQREPathTracer::TraceStrategicPath(const MixedStrategyProfile<double> &p
     while (x[x.Length()] < p_maxLambda) {
       TracePath(x, p_maxLambda, p_omega);
       if (x[x.Length()] < p_maxLambda) {
-	std::cout << std::endl;
+	*m_stream << std::endl;
       }
     }
   }
@@ -58,6 +58,28 @@ StrategicQREPathTracer::TraceStrategicPath(const MixedStrategyProfile<double> &p
   }
 }
 
+bool
+StrategicQREPathTracer::SolveAtLambda(double p_lambda,
+				      MixedStrategyProfile<double> &p_profile)
+{
+  // The principal branch starts at the centroid
+  MixedStrategyProfile<double> centroid(m_start.GetSupport().NewMixedStrategyProfile<double>());
+  Vector<double> origin(centroid.MixedProfileLength() + 1);
+  for (int i = 1; i <= centroid.MixedProfileLength(); i++) {
+    origin[i] = log(centroid[i]);
+  }
+  origin[origin.Length()] = 0.0;
+
+  Vector<double> x(origin.Length());
+  if (!SolveAtParam(p_lambda, origin, x)) {
+    return false;
+  }
+  for (int i = 1; i <= p_profile.MixedProfileLength(); i++) {
+    p_profile[i] = exp(x[i]);
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 //             StrategicQREPathTracer: Providing virtual functions
 //----------------------------------------------------------------------------
@@ -221,6 +243,98 @@ StrategicQREPathTracer::LogLike(const Array<double> &p_point)
   return ret;
 }
 
+//
+// Returns the derivative of the log-likelihood with respect to lambda at
+// the point on the branch.  The coordinates are the logarithms of the
+// probabilities, so this is just their derivatives weighted by the counts.
+//
+double
+StrategicQREPathTracer::LogLikeDeriv(const Vector<double> &p_point)
+{
+  Vector<double> deriv(p_point.Length());
+  if (!GetParamDerivative(p_point, deriv)) {
+    return 0.0;
+  }
+  double ret = 0.0;
+  for (int i = 1; i <= m_frequencies.Length(); i++) {
+    ret += m_frequencies[i] * deriv[i];
+  }
+  return ret;
+}
+
+bool
+StrategicQREPathTracer::EstimateMLE(const MixedStrategyProfile<double> &p_start,
+				    double p_maxLambda, double &p_lambda,
+				    MixedStrategyProfile<double> &p_profile,
+				    double &p_logLike, double &p_stdErr)
+{
+  int n = p_start.MixedProfileLength();
+  Vector<double> x(n + 1), last(n + 1), t(n + 1);
+  for (int i = 1; i <= n; i++) {
+    x[i] = log(p_start[i]);
+  }
+  x[n + 1] = 0.0;
+
+  bool found = false;
+  double omega = 1.0;
+  m_estimatePoint = &last;
+  try {
+    while (x[n + 1] < p_maxLambda) {
+      last = x;
+      m_estimateEnded = false;
+      // With frequencies set, the criterion is the derivative of the
+      // log-likelihood along the branch; the trace stops just past each
+      // of its zeros, with the zero itself as the last point reported.
+      TracePath(x, p_maxLambda, omega);
+      if (m_estimateEnded || x == last) {
+	break;
+      }
+
+      // Resume the trace in the direction it was going
+      GetTangent(x, t);
+      omega = (t * (x - last) >= 0.0) ? 1.0 : -1.0;
+
+      // The observed information is the negative of the second
+      // derivative of the log-likelihood, which is obtained by
+      // differencing the first derivative at nearby points.
+      double lambda = last[n + 1];
+      double delta = 1.0e-4 * std::max(1.0, lambda);
+      if (lambda - delta <= 0.0) {
+	continue;
+      }
+      Vector<double> lo(last), hi(last);
+      if (!NewtonAtParam(lo, lambda - delta) || 
+	  !NewtonAtParam(hi, lambda + delta)) {
+	continue;
+      }
+      double info = -(LogLikeDeriv(hi) - LogLikeDeriv(lo)) / (2.0 * delta);
+      if (info <= 0.0) {
+	// Not a local maximum
+	continue;
+      }
+
+      MixedStrategyProfile<double> profile(p_start);
+      for (int i = 1; i <= n; i++) {
+	profile[i] = exp(last[i]);
+      }
+      double logLike = LogLike((const Vector<double> &) profile);
+      if (!found || logLike > p_logLike) {
+	found = true;
+	p_lambda = lambda;
+	p_profile = profile;
+	p_logLike = logLike;
+	p_stdErr = 1.0 / sqrt(info);
+      }
+    }
+  }
+  catch (...) {
+    m_estimatePoint = 0;
+    throw;
+  }
+  m_estimatePoint = 0;
+  return found;
+}
+
 
 //----------------------------------------------------------------------------
 //                StrategicQREPathTracer: Outputting profiles
@@ -262,8 +376,13 @@ StrategicQREPathTracer::PrintProfile(std::ostream &p_stream,
 void 
 StrategicQREPathTracer::OnStep(const Vector<double> &x, bool p_isTerminal = false)
 {
+  if (m_estimatePoint) {
+    *m_estimatePoint = x;
+    m_estimateEnded = p_isTerminal;
+    return;
+  }
   if ((m_fullGraph && !p_isTerminal) || (!m_fullGraph && p_isTerminal)) {
-    PrintProfile(std::cout, x, p_isTerminal);
+    PrintProfile(*m_stream, x, p_isTerminal);
   }
 }
 
@@ -29,7 +29,8 @@
 class StrategicQREPathTracer : public PathTracer {
 public:
   StrategicQREPathTracer(const MixedStrategyProfile<double> &p_start) 
-    : m_start(p_start), m_fullGraph(true), m_decimals(6)
+    : m_start(p_start), m_fullGraph(true), m_decimals(6),
+      m_stream(&std::cout), m_estimatePoint(0), m_estimateEnded(false)
     { SetTargetParam(-1.0); }
   virtual ~StrategicQREPathTracer() { }
 
@@ -43,12 +44,33 @@ public:
   void SetDecimals(int p_decimals) { m_decimals = p_decimals; }
   int GetDecimals(void) const { return m_decimals; }
 
+  // Stream to which the points on the branch are written
+  void SetStream(std::ostream &p_stream) { m_stream = &p_stream; }
+  std::ostream &GetStream(void) const { return *m_stream; }
+
   void SetMLEFrequencies(const Array<double> &p_frequencies)
   { m_frequencies = p_frequencies; }
   const Array<double> &GetMLEFrequencies(void) const { return m_frequencies; }
   
   bool IsMLEMode(void) const { return (m_frequencies.Length() > 0); }
 
+  // Estimate lambda by maximum likelihood, using the frequencies set by
+  // SetMLEFrequencies() as counts of observed play.  The branch from
+  // p_start is traced once, stopping at each zero of the derivative of
+  // the log-likelihood along the branch.  Of the local maxima found
+  // below p_maxLambda, the one with the greatest likelihood is returned,
+  // with the standard error of lambda from the observed information.
+  // Returns false if no local maximum is found.
+  bool EstimateMLE(const MixedStrategyProfile<double> &p_start,
+		   double p_maxLambda, double &p_lambda, 
+		   MixedStrategyProfile<double> &p_profile,
+		   double &p_logLike, double &p_stdErr);
+
+  // Compute the QRE on the principal branch at p_lambda directly,
+  // without tracing the branch from the centroid where possible.
+  // Returns false if no such point could be found.
+  bool SolveAtLambda(double p_lambda, MixedStrategyProfile<double> &p_profile);
+
 
 protected:
   virtual void OnStep(const Vector<double> &, bool);
@@ -65,12 +87,16 @@ private:
 
   // Used in maximum likelihood estimation
   double LogLike(const Array<double> &p_point);
+  double LogLikeDeriv(const Vector<double> &p_point);
 
   MixedStrategyProfile<double> m_start;
   bool m_fullGraph;
   Array<double> m_frequencies;
   int m_decimals;
-  
+  std::ostream *m_stream;
+  // Set while estimating, to receive the points found instead of output
+  Vector<double> *m_estimatePoint;
+  bool m_estimateEnded;
 };
 
 
@@ -104,11 +104,135 @@ static void NewtonStep(Matrix<double> &q, Matrix<double> &b,
   d = sqrt(d);
 }
 
+//
+// Performs a Broyden rank-one update of the factorization q * J^T = b,
+// given the secant step s and the corresponding change y in the LHS.
+// The update is carried out directly on the factors using Givens
+// rotations, so no refactorization is required.
+//
+static void BroydenUpdate(Matrix<double> &b, Matrix<double> &q,
+			  const Vector<double> &s, const Vector<double> &y)
+{
+  double ss = s * s;
+  if (ss == 0.0) {
+    return;
+  }
+
+  // z = q * s; then J * s = b^T * z
+  Vector<double> z(q.NumRows());
+  for (int k = 1; k <= q.NumRows(); k++) {
+    z[k] = 0.0;
+    for (int l = 1; l <= q.NumColumns(); l++) {
+      z[k] += q(k, l) * s[l];
+    }
+  }
+
+  Vector<double> w(b.NumColumns());
+  for (int k = 1; k <= b.NumColumns(); k++) {
+    w[k] = y[k];
+    for (int l = 1; l <= k; l++) {
+      w[k] -= b(l, k) * z[l];
+    }
+  }
+
+  // Reduce z to a multiple of the first unit vector; this leaves
+  // b in upper Hessenberg form
+  for (int k = q.NumRows(); k >= 2; k--) {
+    Givens(b, q, z[k-1], z[k], k-1, k, k-1);
+  }
+  
+  for (int l = 1; l <= b.NumColumns(); l++) {
+    b(1, l) += z[1] * w[l] / ss;
+  }
+
+  // Restore b to upper triangular form
+  for (int k = 1; k <= b.NumColumns(); k++) {
+    Givens(b, q, b(k, k), b(k+1, k), k, k+1, k+1);
+  }
+}
+
+
+//
+// Solves the square system a * x = b by Gaussian elimination with
+// partial pivoting; the solution overwrites b, and a is destroyed.
+// Returns false if the matrix is (numerically) singular.
+//
+static bool LinearSolve(Matrix<double> &a, Vector<double> &b)
+{
+  int n = b.Length();
+  for (int k = 1; k <= n; k++) {
+    int pivot = k;
+    for (int i = k + 1; i <= n; i++) {
+      if (fabs(a(i, k)) > fabs(a(pivot, k))) {
+	pivot = i;
+      }
+    }
+    if (a(pivot, k) == 0.0) {
+      return false;
+    }
+    if (pivot != k) {
+      a.SwitchRows(pivot, k);
+      std::swap(b[pivot], b[k]);
+    }
+    for (int i = k + 1; i <= n; i++) {
+      double factor = a(i, k) / a(k, k);
+      for (int j = k + 1; j <= n; j++) {
+	a(i, j) -= factor * a(k, j);
+      }
+      b[i] -= factor * b[k];
+    }
+  }
+
+  for (int k = n; k >= 1; k--) {
+    for (int j = k + 1; j <= n; j++) {
+      b[k] -= a(k, j) * b[j];
+    }
+    b[k] /= a(k, k);
+  }
+  return true;
+}
 
 //----------------------------------------------------------------------------
 //             PathTracer: Implementation of path-following engine
 //----------------------------------------------------------------------------
 
+double
+PathTracer::StepCriterion(const Vector<double> &p_point,
+			  const Vector<double> &p_tangent)
+{
+  if (m_seeking) {
+    return p_point[p_point.Length()] - m_seekParam;
+  }
+  return Criterion(p_point, p_tangent);
+}
+
+void 
+PathTracer::ReportStep(const Vector<double> &p_point, bool p_isTerminal)
+{
+  if (m_seeking) {
+    if (!p_isTerminal) {
+      *m_seekPoint = p_point;
+    }
+    return;
+  }
+  OnStep(p_point, p_isTerminal);
+}
+
+void
+PathTracer::RecordStep(const Vector<double> &p_point,
+		       const Vector<double> &p_tangent, double p_omega)
+{
+  if (!m_recordBranch || m_seeking) {
+    return;
+  }
+  // Tracing may resume from the last point recorded
+  if (m_branch.NumPoints() > 0 &&
+      m_branch.GetPoint(m_branch.NumPoints()) == p_point) {
+    return;
+  }
+  m_branch.Append(p_point, p_tangent * p_omega);
+}
+
 void 
 PathTracer::TracePath(Vector<double> &x,
 		      double p_maxLambda, double &p_omega)
@@ -121,20 +245,30 @@ PathTracer::TracePath(Vector<double> &x,
   double h = m_hStart;             // initial stepsize
   const double c_hmin = 1.0e-8;    // minimal stepsize
   const int c_maxIter = 100;       // maximum iterations in corrector
+  const double c_minCos = 0.99;    // minimal cosine of angle between
+                                   // tangents when using Broyden updates
   
   bool newton = false;             // using Newton steplength (for zero-finding)
+  bool refresh = false;            // recompute Jacobian on next Broyden step
 
   Vector<double> u(x.Length()), restart(x.Length());
   // t is current tangent at x; newT is tangent at u, which is the next point.
   Vector<double> t(x.Length()), newT(x.Length());
   Vector<double> y(x.Length() - 1);
+  // Previous corrector iterate and its LHS, for Broyden updates
+  Vector<double> uOld(x.Length()), yOld(x.Length() - 1);
   Matrix<double> b(x.Length(), x.Length() - 1);
   SquareMatrix<double> q(x.Length());
 
-  OnStep(x, false);
+  ReportStep(x, false);
   GetJacobian(x, b);
   QRDecomp(b, q);
   q.GetRow(q.NumRows(), t);
+  RecordStep(x, t, p_omega);
+  if (m_broyden) {
+    uOld = x;
+    GetLHS(x, yOld);
+  }
   
   while (x[x.Length()] >= 0.0 && x[x.Length()] < p_maxLambda) {
     bool accept = true;
@@ -153,8 +287,14 @@ PathTracer::TracePath(Vector<double> &x,
     }
 
     double decel = 1.0 / m_maxDecel;  // initialize deceleration factor
-    GetJacobian(u, b);
-    QRDecomp(b, q);
+    // When using Broyden updates, the factorization is carried over from
+    // the previous step unless it has been found wanting.
+    bool fresh = !m_broyden || refresh;
+    if (fresh) {
+      GetJacobian(u, b);
+      QRDecomp(b, q);
+      refresh = false;
+    }
 
     int iter = 1;
     double disto = 0.0;
@@ -162,6 +302,15 @@ PathTracer::TracePath(Vector<double> &x,
       double dist;
 
       GetLHS(u, y);
+      if (m_broyden) {
+	// If the factorization is carried over, the first update uses
+	// the secant from the last iterate of the previous step
+	if (iter >= 2 || !fresh) {
+	  BroydenUpdate(b, q, u - uOld, y - yOld);
+	}
+	uOld = u;
+	yOld = y;
+      }
       NewtonStep(q, b, u, y, dist); 
 
       if (dist >= c_maxDist) {
@@ -186,7 +335,11 @@ PathTracer::TracePath(Vector<double> &x,
       disto = dist;
       iter++;
       if (iter > c_maxIter) {
-	OnStep(x, true);
+	if (!fresh) {
+	  accept = false;
+	  break;
+	}
+	ReportStep(x, true);
 	if (newton) {
 	  // Restore the place to restart if desired
 	  x = restart;
@@ -196,9 +349,14 @@ PathTracer::TracePath(Vector<double> &x,
     }
 
     if (!accept) {
+      if (!fresh) {
+	// Retry the step with the true Jacobian before cutting the stepsize
+	refresh = true;
+	continue;
+      }
       h /= m_maxDecel;   // PC not accepted; change stepsize and retry
       if (fabs(h) <= c_hmin) {
-	OnStep(x, true);
+	ReportStep(x, true);
 	if (newton) {
 	  // Restore the place to restart if desired
 	  x = restart;
@@ -217,15 +375,24 @@ PathTracer::TracePath(Vector<double> &x,
     // Obtain the tangent at the next step
     q.GetRow(q.NumRows(), newT); 
 
+    if (!fresh && t * newT < c_minCos) {
+      // Tangent has turned too sharply to trust the updated Jacobian
+      refresh = true;
+      continue;
+    }
+
+    // Points found while homing in on a zero of the criterion are not
+    // recorded, as the steps may then run in either direction
+    bool record = !newton;
     if (!newton &&
-	Criterion(x, t) * Criterion(u, newT) < 0.0) {
+	StepCriterion(x, t) * StepCriterion(u, newT) < 0.0) {
       newton = true;
       restart = u;
     }
 
     if (newton) {
       // Newton-type steplength adaptation, secant method
-      h *= -Criterion(u, newT) / (Criterion(u, newT) - Criterion(x, t));
+      h *= -StepCriterion(u, newT) / (StepCriterion(u, newT) - StepCriterion(x, t));
     }
     else {
       // Standard steplength adaptation
@@ -234,7 +401,7 @@ PathTracer::TracePath(Vector<double> &x,
 
     // PC step was successful; update and iterate
     x = u;
-    OnStep(x, false);
+    ReportStep(x, false);
 
     if (t * newT < 0.0) {
       // Bifurcation detected; for now, just "jump over" and continue,
@@ -243,11 +410,194 @@ PathTracer::TracePath(Vector<double> &x,
       p_omega = -p_omega;
     }
     t = newT;
+    if (record) {
+      RecordStep(x, t, p_omega);
+    }
   }
 
-  OnStep(x, true);
+  ReportStep(x, true);
   if (newton) {
     x = restart;
   }
 }
 
+//----------------------------------------------------------------------------
+//        PathTracer: Computing the point at a given parameter value
+//----------------------------------------------------------------------------
+
+//
+// Damped Newton's method on the system with the parameter held fixed.
+//
+bool
+PathTracer::NewtonAtParam(Vector<double> &x, double p_param)
+{
+  const double c_tol = 1.0e-10;    // tolerance on length of Newton step
+  const int c_maxIter = 50;        // maximum number of Newton iterations
+  const int c_maxHalvings = 10;    // maximum number of step halvings
+  
+  int n = x.Length() - 1;
+  Vector<double> lhs(n), step(n), trial(x.Length()), trialLHS(n);
+  Matrix<double> b(x.Length(), n), a(n, n);
+
+  x[x.Length()] = p_param;
+  GetLHS(x, lhs);
+  double norm = sqrt(lhs * lhs);
+
+  for (int iter = 1; iter <= c_maxIter; iter++) {
+    // The Jacobian is computed in transposed form, with an extra row
+    // for the derivatives with respect to the parameter
+    GetJacobian(x, b);
+    for (int i = 1; i <= n; i++) {
+      for (int j = 1; j <= n; j++) {
+	a(i, j) = b(j, i);
+      }
+      step[i] = -lhs[i];
+    }
+    if (!LinearSolve(a, step)) {
+      return false;
+    }
+
+    // Halve the step until the residual decreases
+    double alpha = 1.0;
+    trial[trial.Length()] = p_param;
+    for (int halving = 0; ; halving++) {
+      for (int i = 1; i <= n; i++) {
+	trial[i] = x[i] + alpha * step[i];
+      }
+      GetLHS(trial, trialLHS);
+      double trialNorm = sqrt(trialLHS * trialLHS);
+      if (trialNorm < (1.0 - 0.5 * alpha) * norm || trialNorm == 0.0) {
+	norm = trialNorm;
+	break;
+      }
+      if (halving == c_maxHalvings) {
+	// No decrease; accept only if already at the solution
+	return (sqrt(step * step) <= c_tol);
+      }
+      alpha *= 0.5;
+    }
+    x = trial;
+    lhs = trialLHS;
+
+    if (alpha * sqrt(step * step) <= c_tol) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+PathTracer::GetTangent(const Vector<double> &p_point, Vector<double> &p_tangent)
+{
+  Matrix<double> b(p_point.Length(), p_point.Length() - 1);
+  SquareMatrix<double> q(p_point.Length());
+  GetJacobian(p_point, b);
+  QRDecomp(b, q);
+  q.GetRow(q.NumRows(), p_tangent);
+}
+
+bool
+PathTracer::GetParamDerivative(const Vector<double> &p_point,
+			       Vector<double> &p_deriv)
+{
+  int n = p_point.Length() - 1;
+  Matrix<double> b(p_point.Length(), n), a(n, n);
+  Vector<double> rhs(n);
+  GetJacobian(p_point, b);
+  for (int i = 1; i <= n; i++) {
+    for (int j = 1; j <= n; j++) {
+      a(i, j) = b(j, i);
+    }
+    rhs[i] = -b(n + 1, i);
+  }
+  if (!LinearSolve(a, rhs)) {
+    return false;
+  }
+  for (int i = 1; i <= n; i++) {
+    p_deriv[i] = rhs[i];
+  }
+  p_deriv[n + 1] = 1.0;
+  return true;
+}
+
+//
+// Traces the path from x, which should lie on the path, in the direction
+// of increasing parameter until reaching p_param, and polishes the point
+// found using Newton's method.
+//
+bool 
+PathTracer::TraceToParam(Vector<double> &x, double p_param)
+{
+  // Orient the trace so the parameter is initially increasing
+  Vector<double> t(x.Length());
+  GetTangent(x, t);
+  double omega = (t[t.Length()] >= 0.0) ? 1.0 : -1.0;
+
+  Vector<double> y(x), found(x);
+  m_seeking = true;
+  m_seekParam = p_param;
+  m_seekPoint = &found;
+  try {
+    TracePath(y, 2.0 * p_param + 1.0, omega);
+  }
+  catch (...) {
+    m_seeking = false;
+    throw;
+  }
+  m_seeking = false;
+
+  if (fabs(found[found.Length()] - p_param) > 
+      1.0e-4 * std::max(1.0, p_param)) {
+    return false;
+  }
+  x = found;
+  return NewtonAtParam(x, p_param);
+}
+
+bool
+PathTracer::SolveAtParam(double p_param, const Vector<double> &p_origin,
+			 Vector<double> &p_x)
+{
+  // A stored branch gives a point close to the solution, if the branch
+  // reaches this far
+  if (m_branch.NumPoints() > 0 && m_branch.Dimension() == p_origin.Length()) {
+    p_x = p_origin;
+    if (m_branch.Interpolate(p_param, p_x) && NewtonAtParam(p_x, p_param)) {
+      return true;
+    }
+  }
+
+  if (m_solutions.Length() == 0) {
+    m_solutions.Append(p_origin);
+  }
+
+  // Find the nearest known point, and the nearest from below
+  int nearest = 1, below = 0;
+  for (int i = 1; i <= m_solutions.Length(); i++) {
+    double param = m_solutions[i][p_origin.Length()];
+    if (fabs(param - p_param) <
+	fabs(m_solutions[nearest][p_origin.Length()] - p_param)) {
+      nearest = i;
+    }
+    if (param <= p_param &&
+	(below == 0 || param > m_solutions[below][p_origin.Length()])) {
+      below = i;
+    }
+  }
+
+  p_x = m_solutions[nearest];
+  bool found = NewtonAtParam(p_x, p_param);
+  if (!found && below > 0) {
+    p_x = m_solutions[below];
+    found = TraceToParam(p_x, p_param);
+  }
+  if (!found && (below == 0 || m_solutions[below] != p_origin)) {
+    p_x = p_origin;
+    found = TraceToParam(p_x, p_param);
+  }
+  
+  if (found) {
+    m_solutions.Append(p_x);
+  }
+  return found;
+}
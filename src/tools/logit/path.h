@@ -23,6 +23,8 @@
 #ifndef PATH_H
 #define PATH_H
 
+#include "branch.h"
+
 using namespace Gambit;
 
 //
@@ -41,13 +43,53 @@ public:
   void SetTargetParam(double p_targetParam) { m_targetParam = p_targetParam; }
   double GetTargetParam(void) const { return m_targetParam; }
 
+  // If set, the factorization of the Jacobian is carried across steps
+  // and revised using Broyden rank-one updates in the corrector.
+  // The true Jacobian is only recomputed when the corrector fails to
+  // contract adequately, or the tangent turns too sharply.
+  void SetBroydenUpdates(bool p_broyden) { m_broyden = p_broyden; }
+  bool GetBroydenUpdates(void) const { return m_broyden; }
+
+  // If set, the points accepted while tracing are recorded, with their
+  // tangents, in the branch.  A nonempty branch, whether recorded or set
+  // from a saved copy, supplies starting points for SolveAtParam().
+  void SetRecordBranch(bool p_record) { m_recordBranch = p_record; }
+  bool GetRecordBranch(void) const { return m_recordBranch; }
+  const PathBranch &GetBranch(void) const { return m_branch; }
+  void SetBranch(const PathBranch &p_branch) { m_branch = p_branch; }
+
 protected:
-  PathTracer(void) : m_maxDecel(1.1), m_hStart(0.03), m_targetParam(0.0) 
+  PathTracer(void) : m_maxDecel(1.1), m_hStart(0.03), m_targetParam(0.0),
+		     m_broyden(false), m_recordBranch(false), 
+		     m_seeking(false), m_seekParam(0.0), m_seekPoint(0)
     { } 
   virtual ~PathTracer() { }
 
   void TracePath(Vector<double> &p_x, double p_maxLambda, double &p_omega);
 
+  // Compute the point on the path at which the parameter (the last
+  // coordinate) equals p_param, without tracing the path from its
+  // start where possible.  Newton's method is applied with the parameter
+  // held fixed, starting from the nearest point previously found by this
+  // function.  If that fails, the path is traced from the nearest such
+  // point with a lower parameter value, and finally from p_origin.
+  // Returns true on success, with the point in p_x.
+  bool SolveAtParam(double p_param, const Vector<double> &p_origin,
+		    Vector<double> &p_x);
+
+  // Apply Newton's method to the system with the parameter held fixed
+  // at p_param, starting from p_x.  Returns true on convergence.
+  bool NewtonAtParam(Vector<double> &p_x, double p_param);
+
+  // Compute the unit tangent to the path at the point, in the orientation
+  // TracePath() would take from that point with p_omega = 1.
+  void GetTangent(const Vector<double> &p_point, Vector<double> &p_tangent);
+  // Compute the derivative of the other coordinates with respect to the
+  // parameter, treating the path as locally a function of the parameter.
+  // Returns false if the path turns back at the point.
+  bool GetParamDerivative(const Vector<double> &p_point, 
+			  Vector<double> &p_deriv);
+
   // Criterion function: path tracer attempts to compute a zero of this function.
   virtual double Criterion(const Vector<double> &p_point, 
 			   const Vector<double> &p_tangent) { return -1.0; }
@@ -62,6 +104,24 @@ protected:
 
 private:
   double m_maxDecel, m_hStart, m_targetParam;
+  bool m_broyden, m_recordBranch;
+  PathBranch m_branch;
+
+  // Points found by SolveAtParam(), used as starting points for later calls
+  List<Vector<double> > m_solutions;
+  // Set while tracing to a parameter value in SolveAtParam()
+  bool m_seeking;
+  double m_seekParam;
+  Vector<double> *m_seekPoint;
+
+  bool TraceToParam(Vector<double> &p_x, double p_param);
+
+  // Wrappers which substitute for the virtual functions when seeking
+  double StepCriterion(const Vector<double> &p_point,
+		       const Vector<double> &p_tangent);
+  void ReportStep(const Vector<double> &p_point, bool p_isTerminal);
+  void RecordStep(const Vector<double> &p_point, const Vector<double> &p_tangent,
+		  double p_omega);
 };
 
 #endif  // PATH_H
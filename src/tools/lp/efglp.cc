@@ -24,11 +24,12 @@
 #include <unistd.h>
 #include <iostream>
 #include "libgambit/libgambit.h"
-#include "liblinear/lpsolve.h"
+#include "liblinear/dualsimplex.h"
 
 using namespace Gambit;
 
 extern int g_numDecimals;
+extern bool g_hybrid;
 
 //
 // Structure for caching data which might take a little time to compute
@@ -53,7 +54,7 @@ struct GameData {
 template <class T>
 void BuildConstraintMatrix(GameData &p_data,
 			   const BehavSupport &p_support,
-			   Matrix<T> &A, const GameNode &n, const T &prob,
+			   SparseMatrix<T> &A, const GameNode &n, const T &prob,
 			   int s1, int s2, int i1, int i2)
 {
   GameOutcome outcome = n->GetOutcome();
@@ -107,7 +108,7 @@ void BuildConstraintMatrix(GameData &p_data,
 //
 template <class T>
 void PrintCPLEX(std::ostream &p_stream,
-		const Matrix<T> &A,
+		const SparseMatrix<T> &A,
 		const Vector<T> &b,
 		const Vector<T> &c,
 		int nequals)
@@ -158,41 +159,33 @@ void PrintCPLEX(std::ostream &p_stream,
 // similarly, the array p_dual should have the same length as the
 // number of rows in A, and the routine returns the dual solution.
 //
+// In hybrid mode, the LP is solved first in floating point, and the
+// exact solve starts from the optimal basis found.
+//
 // To implement your own custom solver for this problem, simply
 // replace this function.
 //
 template <class T> bool
-SolveLP(const Matrix<T> &A, const Vector<T> &b, const Vector<T> &c,
+SolveLP(const SparseMatrix<T> &A, const Vector<T> &b, const Vector<T> &c,
 	int nequals,
 	Array<T> &p_primal, Array<T> &p_dual)
 {
-  LPSolve<T> LP(A, b, c, nequals);
-  if (!LP.IsAborted()) {
-    BFS<T> cbfs;
-    LP.OptBFS(cbfs);
-
-    for (int i = 1; i <= A.NumColumns(); i++) {
-      if (cbfs.count(i)) {
-	p_primal[i] = cbfs[i];
-      }
-      else {
-	p_primal[i] = (T) 0;
-      }
-    }
-
-    for (int i = 1; i <= A.NumRows(); i++) {
-      if (cbfs.count(-i)) {
-	p_dual[i] = cbfs[-i];
-      }
-      else {
-	p_dual[i] = (T) 0;
-      }
-    }
-    return true;
+  Array<int> start;
+  if (g_hybrid) {
+    start = FloatingPointBasis(A, b, c, nequals);
   }
-  else {
+  DualSimplex<T> LP(A, b, c, nequals, start);
+  if (!LP.IsFeasible() || !LP.IsBounded()) {
     return false;
   }
+
+  for (int i = 1; i <= A.NumColumns(); i++) {
+    p_primal[i] = LP.OptimumVector()[i];
+  }
+  for (int i = 1; i <= A.NumRows(); i++) {
+    p_dual[i] = LP.DualVector()[i];
+  }
+  return true;
 }
 
 template <class T>
@@ -419,8 +412,6 @@ void SequenceToBehavior(const GameData &p_data,
 template <class T>
 void SolveExtensive(const Game &p_game)
 {
-  BFS<T> cbfs;
-  
   BehavSupport support(p_game);
 
   // Cache some data for convenience
@@ -446,11 +437,10 @@ void SolveExtensive(const Game &p_game)
   }
   data.minpay = p_game->GetMinPayoff();
 
-  Matrix<T> A(1, data.ns1 + data.ni2, 1, data.ns2 + data.ni1);
+  SparseMatrix<T> A(1, data.ns1 + data.ni2, 1, data.ns2 + data.ni1);
   Vector<T> b(1, data.ns1 + data.ni2);
   Vector<T> c(1, data.ns2 + data.ni1);
 
-  A = (T) 0;
   b = (T) 0;
   c = (T) 0;
 
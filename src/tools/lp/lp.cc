@@ -49,6 +49,8 @@ void PrintHelp(char *progname)
   std::cerr << "Options:\n";
   std::cerr << "  -d DECIMALS      compute using floating-point arithmetic;\n";
   std::cerr << "                   display results with DECIMALS digits\n";
+  std::cerr << "  -H               compute in floating point, then check and\n";
+  std::cerr << "                   repair the result in exact arithmetic\n";
   std::cerr << "  -S               use strategic game\n";
   std::cerr << "  -h, --help       print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
@@ -57,6 +59,7 @@ void PrintHelp(char *progname)
 }
 
 int g_numDecimals = 6;
+bool g_hybrid = false;
 
 int main(int argc, char *argv[])
 {
@@ -69,7 +72,7 @@ int main(int argc, char *argv[])
     { "version", 0, NULL, 'v'  },
     { 0,    0,    0,    0   }
   };
-  while ((c = getopt_long(argc, argv, "d:vqhS", long_options, &long_opt_index)) != -1) {
+  while ((c = getopt_long(argc, argv, "d:vqhHS", long_options, &long_opt_index)) != -1) {
     switch (c) {
     case 'v':
       PrintBanner(std::cerr); exit(1);
@@ -80,6 +83,9 @@ int main(int argc, char *argv[])
     case 'h':
       PrintHelp(argv[0]);
       break;
+    case 'H':
+      g_hybrid = true;
+      break;
     case 'q':
       quiet = true;
       break;
@@ -99,6 +105,11 @@ int main(int argc, char *argv[])
     }
   }
 
+  if (useFloat) {
+    // the results are in floating point already
+    g_hybrid = false;
+  }
+
   if (!quiet) {
     PrintBanner(std::cerr);
   }
@@ -24,11 +24,12 @@
 #include <unistd.h>
 #include <iostream>
 #include "libgambit/libgambit.h"
-#include "liblinear/lpsolve.h"
+#include "liblinear/dualsimplex.h"
 
 using namespace Gambit;
 
 extern int g_numDecimals;
+extern bool g_hybrid;
 
 //
 // The routine to actually solve the LP
@@ -40,6 +41,9 @@ extern int g_numDecimals;
 // similarly, the array p_dual should have the same length as the
 // number of rows in A, and the routine returns the dual solution.
 //
+// In hybrid mode, the LP is solved first in floating point, and the
+// exact solve starts from the optimal basis found.
+//
 // To implement your own custom solver for this problem, simply
 // replace this function.
 //
@@ -48,33 +52,23 @@ SolveLP(const Matrix<T> &A, const Vector<T> &b, const Vector<T> &c,
 	int nequals,
 	Array<T> &p_primal, Array<T> &p_dual)
 {
-  LPSolve<T> LP(A, b, c, nequals);
-  if (!LP.IsAborted()) {
-    BFS<T> cbfs;
-    LP.OptBFS(cbfs);
-
-    for (int i = 1; i <= A.NumColumns(); i++) {
-      if (cbfs.count(i)) {
-	p_primal[i] = cbfs[i];
-      }
-      else {
-	p_primal[i] = (T) 0;
-      }
-    }
-
-    for (int i = 1; i <= A.NumRows(); i++) {
-      if (cbfs.count(-i)) {
-	p_dual[i] = cbfs[-i];
-      }
-      else {
-	p_dual[i] = (T) 0;
-      }
-    }
-    return true;
+  SparseMatrix<T> sparseA(A);
+  Array<int> start;
+  if (g_hybrid) {
+    start = FloatingPointBasis(sparseA, b, c, nequals);
   }
-  else {
+  DualSimplex<T> LP(sparseA, b, c, nequals, start);
+  if (!LP.IsFeasible() || !LP.IsBounded()) {
     return false;
   }
+
+  for (int i = 1; i <= A.NumColumns(); i++) {
+    p_primal[i] = LP.OptimumVector()[i];
+  }
+  for (int i = 1; i <= A.NumRows(); i++) {
+    p_dual[i] = LP.DualVector()[i];
+  }
+  return true;
 }
 
 void PrintProfile(std::ostream &p_stream,